@@ -1,6 +1,21 @@
 #ifndef STONESNGEMS_H_
 #define STONESNGEMS_H_
 
+#include "../../src/async_env_pool.h"
+#include "../../src/batch_simulator.h"
+#include "../../src/beam_search.h"
+#include "../../src/bfs_solver.h"
+#include "../../src/distance_map.h"
+#include "../../src/expand.h"
+#include "../../src/external_bfs_solver.h"
+#include "../../src/frame_buffer.h"
+#include "../../src/hda_solver.h"
+#include "../../src/mcts.h"
+#include "../../src/observation.h"
+#include "../../src/rollout.h"
+#include "../../src/search_result.h"
 #include "../../src/stonesngems_base.h"
+#include "../../src/thread_pool.h"
+#include "../../src/vector_env.h"
 
 #endif    // STONESNGEMS_H_
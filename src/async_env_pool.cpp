@@ -0,0 +1,219 @@
+#include "async_env_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "definitions.h"
+#include "mpmc_queue.h"
+#include "stonesngems_base.h"
+#include "vector_env.h"
+
+namespace stonesngems {
+
+namespace {
+auto resolve_num_threads(std::size_t num_threads) -> std::size_t {
+    if (num_threads == 0) {
+        return std::max(static_cast<std::size_t>(std::thread::hardware_concurrency()), std::size_t{1});
+    }
+    return num_threads;
+}
+}    // namespace
+
+AsyncEnvPool::AsyncEnvPool(const std::vector<GameParameters> &params, std::size_t num_threads)
+    : initial_states(make_env_states(params, "AsyncEnvPool")),
+      states(initial_states),
+      result_queue(initial_states.size()) {
+    const auto shape = initial_states.front().observation_shape();
+    obs_size = shape[0] * shape[1] * shape[2];
+    obs_buffer.resize(states.size() * obs_size);
+    reward_buffer.resize(states.size());
+    signal_buffer.resize(states.size());
+    terminal_buffer.resize(states.size());
+    in_flight.resize(states.size(), 0);
+
+    // Every environment is in at most one queue at a time, so pushes never fail
+    num_threads = resolve_num_threads(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        job_queues.push_back(std::make_unique<MPMCQueue<Job>>(states.size()));
+    }
+    workers.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        workers.emplace_back(&AsyncEnvPool::WorkerLoop, this, i);
+    }
+}
+
+AsyncEnvPool::AsyncEnvPool(const GameParameters &params, std::size_t num_envs, std::size_t num_threads)
+    : AsyncEnvPool(std::vector<GameParameters>(num_envs, params), num_threads) {}
+
+AsyncEnvPool::~AsyncEnvPool() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    cv_job.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+auto AsyncEnvPool::num_envs() const noexcept -> std::size_t {
+    return states.size();
+}
+
+auto AsyncEnvPool::num_threads() const noexcept -> std::size_t {
+    return workers.size();
+}
+
+auto AsyncEnvPool::observation_shape() const noexcept -> std::array<std::size_t, 3> {
+    return initial_states.front().observation_shape();
+}
+
+void AsyncEnvPool::reset() {
+    if (num_in_flight > 0) {
+        throw std::invalid_argument("Cannot reset while environments are in flight");
+    }
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        Submit({i, Action::kNoop, true});
+    }
+    if (num_sleeping_workers.load() > 0) {
+        { const std::lock_guard<std::mutex> lock(mutex); }
+        cv_job.notify_all();
+    }
+}
+
+void AsyncEnvPool::send(const std::vector<std::size_t> &env_ids, const std::vector<Action> &actions) {
+    if (env_ids.size() != actions.size()) {
+        throw std::invalid_argument("Expected one action per environment");
+    }
+    for (const auto env_id : env_ids) {
+        if (env_id >= states.size() || in_flight[env_id] != 0) {
+            throw std::invalid_argument("Environment is invalid or still in flight");
+        }
+    }
+    for (std::size_t i = 0; i < env_ids.size(); ++i) {
+        Submit({env_ids[i], actions[i], false});
+    }
+    if (num_sleeping_workers.load() > 0) {
+        { const std::lock_guard<std::mutex> lock(mutex); }
+        cv_job.notify_all();
+    }
+}
+
+auto AsyncEnvPool::recv(std::size_t batch_size) -> std::vector<std::size_t> {
+    std::vector<std::size_t> env_ids;
+    recv(batch_size, env_ids);
+    return env_ids;
+}
+
+void AsyncEnvPool::recv(std::size_t batch_size, std::vector<std::size_t> &env_ids) {
+    if (batch_size > num_in_flight) {
+        throw std::invalid_argument("Not enough environments in flight");
+    }
+    env_ids.clear();
+    std::size_t env_id = 0;
+    while (env_ids.size() < batch_size) {
+        if (result_queue.try_pop(env_id)) {
+            num_pending_results.fetch_sub(1);
+            in_flight[env_id] = 0;
+            --num_in_flight;
+            env_ids.push_back(env_id);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        receiver_waiting.store(true);
+        cv_result.wait(lock, [&]() { return num_pending_results.load() > 0; });
+        receiver_waiting.store(false);
+    }
+}
+
+auto AsyncEnvPool::observations() const noexcept -> const std::vector<float> & {
+    return obs_buffer;
+}
+
+auto AsyncEnvPool::rewards() const noexcept -> const std::vector<int> & {
+    return reward_buffer;
+}
+
+auto AsyncEnvPool::reward_signals() const noexcept -> const std::vector<uint64_t> & {
+    return signal_buffer;
+}
+
+auto AsyncEnvPool::terminals() const noexcept -> const std::vector<uint8_t> & {
+    return terminal_buffer;
+}
+
+auto AsyncEnvPool::get_state(std::size_t env_idx) const noexcept -> const RNDGameState & {
+    return states[env_idx];
+}
+
+void AsyncEnvPool::Submit(const Job &job) {
+    in_flight[job.env_id] = 1;
+    ++num_in_flight;
+    // Environments stick to one worker's queue while it keeps up, so their state stays in that worker's cache
+    [[maybe_unused]] const bool pushed = job_queues[job.env_id % job_queues.size()]->try_push(job);
+    num_pending_jobs.fetch_add(1);
+}
+
+void AsyncEnvPool::WorkerLoop(std::size_t thread_idx) {
+    Job job;
+    while (true) {
+        if (PopJob(thread_idx, job)) {
+            num_pending_jobs.fetch_sub(1);
+            RunJob(job);
+            [[maybe_unused]] const bool pushed = result_queue.try_push(job.env_id);
+            num_pending_results.fetch_add(1);
+            if (receiver_waiting.load()) {
+                { const std::lock_guard<std::mutex> lock(mutex); }
+                cv_result.notify_one();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        num_sleeping_workers.fetch_add(1);
+        cv_job.wait(lock, [&]() { return stop || num_pending_jobs.load() > 0; });
+        num_sleeping_workers.fetch_sub(1);
+        if (stop) {
+            return;
+        }
+    }
+}
+
+auto AsyncEnvPool::PopJob(std::size_t thread_idx, Job &job) noexcept -> bool {
+    // Own queue first, then steal from the others
+    for (std::size_t i = 0; i < job_queues.size(); ++i) {
+        if (job_queues[(thread_idx + i) % job_queues.size()]->try_pop(job)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AsyncEnvPool::RunJob(const Job &job) noexcept {
+    const std::size_t i = job.env_id;
+    RNDGameState &state = states[i];
+    if (job.reset) {
+        state = initial_states[i];
+        reward_buffer[i] = 0;
+        signal_buffer[i] = 0;
+        terminal_buffer[i] = 0;
+    } else {
+        state.apply_action(job.action);
+        reward_buffer[i] = state.get_current_reward();
+        signal_buffer[i] = state.get_reward_signal();
+        terminal_buffer[i] = static_cast<uint8_t>(state.is_terminal());
+        if (terminal_buffer[i] != 0) {
+            state = initial_states[i];
+        }
+    }
+    state.get_observation(obs_buffer.data() + i * obs_size);
+}
+
+}    // namespace stonesngems
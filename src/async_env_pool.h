@@ -0,0 +1,169 @@
+#ifndef STONESNGEMS_ASYNC_ENV_POOL_H_
+#define STONESNGEMS_ASYNC_ENV_POOL_H_
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "definitions.h"
+#include "mpmc_queue.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+// Pool of environments stepped asynchronously by work-stealing workers.
+// Requests are submitted with send() and finished environments are collected with recv() in completion order, so
+// slow environments do not hold back the rest of the batch. Each environment's latest observation, reward, signal and
+// terminal flag are written into its own preallocated slot. Terminal environments are reset to their initial state
+// in the same way as VectorEnv.
+// send() and recv() should only be called from a single thread, and an environment may not be sent again until it has
+// been returned by recv().
+class AsyncEnvPool {
+public:
+    /**
+     * Create one environment per set of game parameters, and start the workers.
+     * @param params Game parameters for each environment, all must produce the same observation shape
+     * @param num_threads Number of worker threads, 0 uses the hardware concurrency
+     * @throws std::invalid_argument if params is empty or the observation shapes differ
+     */
+    explicit AsyncEnvPool(const std::vector<GameParameters> &params, std::size_t num_threads = 0);
+
+    /**
+     * Create copies of the same environment, and start the workers.
+     * @param params Game parameters shared by every environment
+     * @param num_envs Number of environments
+     * @param num_threads Number of worker threads, 0 uses the hardware concurrency
+     * @throws std::invalid_argument if num_envs is 0
+     */
+    AsyncEnvPool(const GameParameters &params, std::size_t num_envs, std::size_t num_threads = 0);
+
+    ~AsyncEnvPool();
+
+    AsyncEnvPool(const AsyncEnvPool &) = delete;
+    AsyncEnvPool(AsyncEnvPool &&) = delete;
+    auto operator=(const AsyncEnvPool &) -> AsyncEnvPool & = delete;
+    auto operator=(AsyncEnvPool &&) -> AsyncEnvPool & = delete;
+
+    /**
+     * Get the number of environments.
+     * @return Number of environments N
+     */
+    [[nodiscard]] auto num_envs() const noexcept -> std::size_t;
+
+    /**
+     * Get the number of worker threads.
+     * @return Number of workers
+     */
+    [[nodiscard]] auto num_threads() const noexcept -> std::size_t;
+
+    /**
+     * Get the observation shape of a single environment.
+     * @return array indicating observation CHW
+     */
+    [[nodiscard]] auto observation_shape() const noexcept -> std::array<std::size_t, 3>;
+
+    /**
+     * Request a reset of every environment, whose initial observations are then collected with recv().
+     * @throws std::invalid_argument if any environment is still in flight
+     */
+    void reset();
+
+    /**
+     * Request one step for each of the given environments.
+     * @param env_ids Environments to step
+     * @param actions Action to apply to each environment
+     * @throws std::invalid_argument if the sizes differ, or an environment is invalid or still in flight
+     */
+    void send(const std::vector<std::size_t> &env_ids, const std::vector<Action> &actions);
+
+    /**
+     * Wait until the given number of environments have finished their requests.
+     * @param batch_size Number of environments to wait for
+     * @return The finished environments, in completion order
+     * @throws std::invalid_argument if fewer than batch_size environments are in flight
+     */
+    [[nodiscard]] auto recv(std::size_t batch_size) -> std::vector<std::size_t>;
+
+    /**
+     * Wait until the given number of environments have finished their requests.
+     * @param batch_size Number of environments to wait for
+     * @param env_ids Set to the finished environments, in completion order
+     * @throws std::invalid_argument if fewer than batch_size environments are in flight
+     */
+    void recv(std::size_t batch_size, std::vector<std::size_t> &env_ids);
+
+    /**
+     * Get the observation slots of every environment, only valid for environments returned by recv().
+     * @return N x C x H x W flat vector, see RNDGameState::get_observation()
+     */
+    [[nodiscard]] auto observations() const noexcept -> const std::vector<float> &;
+
+    /**
+     * Get the reward slots of every environment, only valid for environments returned by recv().
+     * @return N rewards, see RNDGameState::get_current_reward()
+     */
+    [[nodiscard]] auto rewards() const noexcept -> const std::vector<int> &;
+
+    /**
+     * Get the reward signal slots of every environment, only valid for environments returned by recv().
+     * @return N reward signals, see RNDGameState::get_reward_signal()
+     */
+    [[nodiscard]] auto reward_signals() const noexcept -> const std::vector<uint64_t> &;
+
+    /**
+     * Get the terminal flag slots of every environment, only valid for environments returned by recv().
+     * @return N flags, 1 if the environment finished its episode and was reset
+     */
+    [[nodiscard]] auto terminals() const noexcept -> const std::vector<uint8_t> &;
+
+    /**
+     * Get the current state of an environment, only valid for environments returned by recv().
+     * @param env_idx Index of the environment
+     * @return The state
+     */
+    [[nodiscard]] auto get_state(std::size_t env_idx) const noexcept -> const RNDGameState &;
+
+private:
+    struct Job {
+        std::size_t env_id = 0;
+        Action action = Action::kNoop;
+        bool reset = false;
+    };
+
+    void Submit(const Job &job);
+    void WorkerLoop(std::size_t thread_idx);
+    [[nodiscard]] auto PopJob(std::size_t thread_idx, Job &job) noexcept -> bool;
+    void RunJob(const Job &job) noexcept;
+
+    std::vector<RNDGameState> initial_states;
+    std::vector<RNDGameState> states;
+    std::size_t obs_size;
+    std::vector<float> obs_buffer;
+    std::vector<int> reward_buffer;
+    std::vector<uint64_t> signal_buffer;
+    std::vector<uint8_t> terminal_buffer;
+    std::vector<uint8_t> in_flight;    // Only touched by the calling thread
+    std::size_t num_in_flight = 0;
+
+    std::vector<std::unique_ptr<MPMCQueue<Job>>> job_queues;    // One per worker, idle workers steal from the others
+    MPMCQueue<std::size_t> result_queue;
+    std::atomic<int64_t> num_pending_jobs{0};
+    std::atomic<int64_t> num_pending_results{0};
+    std::atomic<std::size_t> num_sleeping_workers{0};    // Senders only take the lock to notify if someone sleeps
+    std::atomic<bool> receiver_waiting{false};
+    std::mutex mutex;
+    std::condition_variable cv_job;
+    std::condition_variable cv_result;
+    bool stop = false;
+    std::vector<std::thread> workers;
+};
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_ASYNC_ENV_POOL_H_
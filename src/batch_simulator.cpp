@@ -0,0 +1,171 @@
+#include "batch_simulator.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "definitions.h"
+#include "stonesngems_base.h"
+#include "util.h"
+
+namespace stonesngems {
+
+BatchSimulator::BatchSimulator(const RNDGameState &state, std::size_t num_instances)
+    : instances(num_instances, state),
+      num_cells(state.board.rows * state.board.cols),
+      stride(num_instances),
+      grid(num_cells * num_instances, HiddenCellType::kNull),
+      has_updated(num_cells * num_instances, 0),
+      has_changed(num_cells * num_instances, 0),
+      scan(num_cells * num_instances, 0) {
+    if (num_instances == 0) {
+        throw std::invalid_argument("BatchSimulator requires at least one instance");
+    }
+    for (std::size_t inst = 0; inst < num_instances; ++inst) {
+        StoreInstance(inst, state);
+    }
+}
+
+auto BatchSimulator::num_instances() const noexcept -> std::size_t {
+    return stride;
+}
+
+void BatchSimulator::set_instance(std::size_t inst, const RNDGameState &state) {
+    const Board &board = instances[inst].board;
+    if (state.board.rows != board.rows || state.board.cols != board.cols) {
+        throw std::invalid_argument("State does not match the level of the BatchSimulator");
+    }
+    StoreInstance(inst, state);
+}
+
+auto BatchSimulator::get_instance(std::size_t inst) const -> RNDGameState {
+    RNDGameState state = instances[inst];
+    get_instance(inst, state);
+    return state;
+}
+
+void BatchSimulator::get_instance(std::size_t inst, RNDGameState &state) const {
+    state = instances[inst];
+    Board &board = state.board;
+    board.grid.resize(num_cells);
+    board.has_updated.resize(num_cells);
+    board.has_changed.resize(num_cells);
+    for (std::size_t i = 0; i < num_cells; ++i) {
+        board.grid[i] = grid[i * stride + inst];
+        board.has_updated[i] = has_updated[i * stride + inst];
+        board.has_changed[i] = has_changed[i * stride + inst];
+    }
+    state.BindCells();
+}
+
+void BatchSimulator::step(const Action *actions) noexcept {
+    BindInstances();
+
+    // Start of tick and agent updates are per instance
+    for (std::size_t inst = 0; inst < stride; ++inst) {
+        assert(RNDGameState::is_valid_action(actions[inst]));    // NOLINT(*-pointer-arithmetic)
+        RNDGameState &state = instances[inst];
+        state.StartScan();
+        // NOLINTNEXTLINE(*-pointer-arithmetic)
+        state.UpdateAgent(state.board.agent_idx, action_to_direction(actions[inst]));
+    }
+
+    // Board scan in lockstep, each cell is checked across all instances before moving on. The flags are from the start
+    // of the tick: a cell only gets a type the scan updates during the tick by being written to, which marks it as
+    // updated, so the flags never skip a cell the full scan of apply_action would update.
+    for (std::size_t i = 0; i < num_cells; ++i) {
+        const uint8_t *cell_scan = scan.data() + i * stride;          // NOLINT(*-pointer-arithmetic)
+        const uint8_t *cell_updated = has_updated.data() + i * stride;    // NOLINT(*-pointer-arithmetic)
+        uint8_t any_active = 0;
+        for (std::size_t inst = 0; inst < stride; ++inst) {
+            any_active |= cell_scan[inst] & ~cell_updated[inst];    // NOLINT(*-pointer-arithmetic)
+        }
+        if (any_active == 0) {
+            continue;
+        }
+        for (std::size_t inst = 0; inst < stride; ++inst) {
+            // NOLINTNEXTLINE(*-pointer-arithmetic)
+            if (cell_scan[inst] != 0 && cell_updated[inst] == 0) {
+                instances[inst].UpdateCell(i);
+            }
+        }
+    }
+
+    for (std::size_t inst = 0; inst < stride; ++inst) {
+        instances[inst].EndScan();
+        RefreshScan(inst, false);
+    }
+}
+
+void BatchSimulator::step(const std::vector<Action> &actions) {
+    if (actions.size() != stride) {
+        throw std::invalid_argument("Expected one action per instance");
+    }
+    step(actions.data());
+}
+
+auto BatchSimulator::is_terminal(std::size_t inst) const noexcept -> bool {
+    return instances[inst].is_terminal();
+}
+
+auto BatchSimulator::is_solution(std::size_t inst) const noexcept -> bool {
+    return instances[inst].is_solution();
+}
+
+auto BatchSimulator::get_current_reward(std::size_t inst) const noexcept -> int {
+    return instances[inst].get_current_reward();
+}
+
+auto BatchSimulator::get_reward_signal(std::size_t inst) const noexcept -> uint64_t {
+    return instances[inst].get_reward_signal();
+}
+
+auto BatchSimulator::get_hash(std::size_t inst) const noexcept -> uint64_t {
+    return instances[inst].get_hash();
+}
+
+auto BatchSimulator::get_hidden_item(std::size_t inst, std::size_t index) const noexcept -> HiddenCellType {
+    assert(index < num_cells);
+    return grid[index * stride + inst];
+}
+
+// Move the cells of the state into the column of the instance, and keep the rest of the state without its board vectors
+void BatchSimulator::StoreInstance(std::size_t inst, const RNDGameState &state) {
+    for (std::size_t i = 0; i < num_cells; ++i) {
+        grid[i * stride + inst] = state.board.item(i);
+        has_updated[i * stride + inst] = state.board.has_updated[i];
+        has_changed[i * stride + inst] = state.board.has_changed[i];
+    }
+    RNDGameState &instance = instances[inst];
+    instance = state;
+    instance.board.grid = {};
+    instance.board.has_updated = {};
+    instance.board.has_changed = {};
+    RefreshScan(inst, true);
+}
+
+// Point the rules of each instance at its column, the views are rebound on every copy of the states
+void BatchSimulator::BindInstances() noexcept {
+    for (std::size_t inst = 0; inst < stride; ++inst) {
+        RNDGameState &instance = instances[inst];
+        instance.cells = BoardView(grid.data() + inst, has_updated.data() + inst,    // NOLINT(*-pointer-arithmetic)
+                                   has_changed.data() + inst, &instance.board.changed_cells, stride);
+    }
+}
+
+// Only the cells written during the last tick can have changed type
+void BatchSimulator::RefreshScan(std::size_t inst, bool all_cells) noexcept {
+    if (all_cells) {
+        for (std::size_t i = 0; i < num_cells; ++i) {
+            scan[i * stride + inst] = static_cast<uint8_t>(IsScanActive(grid[i * stride + inst]));
+        }
+        return;
+    }
+    for (const auto &changed : instances[inst].board.changed_cells) {
+        scan[changed.index * stride + inst] = static_cast<uint8_t>(IsScanActive(grid[changed.index * stride + inst]));
+    }
+}
+
+}    // namespace stonesngems
@@ -0,0 +1,129 @@
+#ifndef STONESNGEMS_BATCH_SIMULATOR_H_
+#define STONESNGEMS_BATCH_SIMULATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "definitions.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+// Lockstep simulator for many instances of a single level.
+// The boards are kept as a structure of arrays, with the same cell of every instance next to each other
+// (grid[cell * num_instances + instance], likewise the updated and changed flags). Each instance keeps the rest of its
+// state (local state, agent position, hash and changed cells) in an RNDGameState whose rules are pointed at its column
+// of the arrays through a strided BoardView, so the instances are stepped by the rules of RNDGameState. Each tick scans
+// the board once, skips cells which cannot update in any instance with a branch-free pass over the instances, and only
+// runs the rules for the remaining instances.
+class BatchSimulator {
+public:
+    /**
+     * Create copies of the given state, which all share its level and game parameters.
+     * @param state The state every instance starts from
+     * @param num_instances Number of instances K
+     * @throws std::invalid_argument if num_instances is 0
+     */
+    BatchSimulator(const RNDGameState &state, std::size_t num_instances);
+
+    /**
+     * Get the number of instances.
+     * @return Number of instances K
+     */
+    [[nodiscard]] auto num_instances() const noexcept -> std::size_t;
+
+    /**
+     * Replace an instance with the given state.
+     * @param instance Index of the instance
+     * @param state The state to load, which must be from the same level and game parameters
+     * @throws std::invalid_argument if the board dimensions differ
+     */
+    void set_instance(std::size_t instance, const RNDGameState &state);
+
+    /**
+     * Extract an instance as a normal state.
+     * @param instance Index of the instance
+     * @return The state, sharing the game parameters of the simulator
+     */
+    [[nodiscard]] auto get_instance(std::size_t instance) const -> RNDGameState;
+
+    /**
+     * Extract an instance into an existing state, reusing its buffers.
+     * @param instance Index of the instance
+     * @param state The state to write into
+     */
+    void get_instance(std::size_t instance, RNDGameState &state) const;
+
+    /**
+     * Apply one action to every instance, as RNDGameState::apply_action would.
+     * @param actions Pointer to K actions, one per instance
+     */
+    void step(const Action *actions) noexcept;
+
+    /**
+     * Apply one action to every instance, as RNDGameState::apply_action would.
+     * @param actions Vector of K actions, one per instance
+     * @throws std::invalid_argument if the number of actions does not match the number of instances
+     */
+    void step(const std::vector<Action> &actions);
+
+    /**
+     * Check if an instance is terminal, see RNDGameState::is_terminal().
+     * @param instance Index of the instance
+     * @return True if terminal, false otherwise
+     */
+    [[nodiscard]] auto is_terminal(std::size_t instance) const noexcept -> bool;
+
+    /**
+     * Check if an instance is solved, see RNDGameState::is_solution().
+     * @param instance Index of the instance
+     * @return True if solved, false otherwise
+     */
+    [[nodiscard]] auto is_solution(std::size_t instance) const noexcept -> bool;
+
+    /**
+     * Get the reward of an instance from the previous step, see RNDGameState::get_current_reward().
+     * @param instance Index of the instance
+     * @return points collected during the previous step
+     */
+    [[nodiscard]] auto get_current_reward(std::size_t instance) const noexcept -> int;
+
+    /**
+     * Get the reward signal of an instance from the previous step, see RNDGameState::get_reward_signal().
+     * @param instance Index of the instance
+     * @return bit field representing events that occured
+     */
+    [[nodiscard]] auto get_reward_signal(std::size_t instance) const noexcept -> uint64_t;
+
+    /**
+     * Get the hash of an instance, see RNDGameState::get_hash().
+     * @param instance Index of the instance
+     * @return hash value
+     */
+    [[nodiscard]] auto get_hash(std::size_t instance) const noexcept -> uint64_t;
+
+    /**
+     * Get the hidden cell item of an instance at the given index
+     * @param instance Index of the instance
+     * @param index Index of the cell
+     */
+    [[nodiscard]] auto get_hidden_item(std::size_t instance, std::size_t index) const noexcept -> HiddenCellType;
+
+private:
+    void StoreInstance(std::size_t inst, const RNDGameState &state);
+    void BindInstances() noexcept;
+    void RefreshScan(std::size_t inst, bool all_cells) noexcept;
+
+    std::vector<RNDGameState> instances;    // State of each instance outside its cells, the board vectors are empty
+    std::size_t num_cells;
+    std::size_t stride;                     // Number of instances, distance between consecutive cells of one instance
+    std::vector<HiddenCellType> grid;       // Cells of all instances, grid[cell * stride + instance]
+    std::vector<uint8_t> has_updated;
+    std::vector<uint8_t> has_changed;
+    std::vector<uint8_t> scan;              // Flag if the cell held a type the scan updates at the start of the tick
+};
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_BATCH_SIMULATOR_H_
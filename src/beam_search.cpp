@@ -0,0 +1,159 @@
+#include "beam_search.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "definitions.h"
+#include "expand.h"
+#include "search_result.h"
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+namespace {
+constexpr std::size_t kNoTrace = std::numeric_limits<std::size_t>::max();
+
+// Edge into a beam state, used to walk back from the solution to the root
+struct TraceEntry {
+    std::size_t parent;
+    Action action;
+};
+
+// Ranking record of a child, the child itself stays in its slot until selected
+struct Candidate {
+    int score;
+    uint64_t hash;
+    std::size_t slot;
+    std::size_t agent_idx;
+};
+
+auto better(const Candidate &a, const Candidate &b) noexcept -> bool {
+    return a.score != b.score ? a.score < b.score : a.hash < b.hash;
+}
+}    // namespace
+
+auto beam_search(const RNDGameState &state, const BeamOptions &options) -> SearchResult {
+    if (options.beam_width == 0) {
+        throw std::invalid_argument("beam_width must be positive");
+    }
+    const auto start_time = std::chrono::steady_clock::now();
+    SearchResult result;
+    if (state.is_solution()) {
+        result.solved = true;
+        return result;
+    }
+    if (state.is_terminal()) {
+        return result;
+    }
+
+    const std::unique_ptr<ThreadPool> pool =
+        (options.num_threads == 1) ? nullptr : std::make_unique<ThreadPool>(options.num_threads);
+    const std::size_t width = options.beam_width;
+    const auto shape = state.observation_shape();
+
+    // Every slot starts as a copy of the root, so later copy assignments and swaps reuse the board buffers
+    std::vector<RNDGameState> beam(width, state);
+    std::vector<RNDGameState> next_beam(width, state);
+    std::vector<RNDGameState> children(width * kNumChildren, state);
+    std::vector<ChildInfo> infos(width * kNumChildren);
+    std::vector<int> returns(width, 0);
+    std::vector<int> next_returns(width, 0);
+    std::vector<std::size_t> traces(width, 0);
+    std::vector<std::size_t> next_traces(width, 0);
+    std::vector<int> scores(width * kNumChildren, 0);
+    std::vector<Candidate> candidates;
+    candidates.reserve(width * kNumChildren);
+    std::vector<std::size_t> bucket_counts(shape[1] * shape[2], 0);
+    std::vector<TraceEntry> trace{{kNoTrace, Action::kNoop}};
+    std::size_t beam_size = 1;
+
+    const auto expand_slice = [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            RNDGameState *child_states = &children[i * kNumChildren];
+            ChildInfo *child_infos = &infos[i * kNumChildren];
+            expand_shared(beam[i], child_states, child_infos);
+            for (std::size_t c = 0; c < kNumChildren; ++c) {
+                // NOLINTNEXTLINE(*-pointer-arithmetic)
+                const int ret = returns[i] + child_infos[c].reward;
+                // NOLINTNEXTLINE(*-pointer-arithmetic)
+                scores[i * kNumChildren + c] = options.heuristic ? options.heuristic(child_states[c]) : -ret;
+            }
+        }
+    };
+
+    for (std::size_t depth = 0; depth < options.max_depth && beam_size > 0; ++depth) {
+        if (pool) {
+            pool->parallel_for(beam_size, expand_slice);
+        } else {
+            expand_slice(0, beam_size, 0);
+        }
+        result.nodes_expanded += beam_size;
+        result.nodes_generated += beam_size * kNumChildren;
+
+        candidates.clear();
+        for (std::size_t slot = 0; slot < beam_size * kNumChildren; ++slot) {
+            const ChildInfo &info = infos[slot];
+            if (info.is_solution) {
+                result.solved = true;
+                result.solution.push_back(RNDGameState::ALL_ACTIONS[slot % kNumChildren]);
+                for (std::size_t t = traces[slot / kNumChildren]; trace[t].parent != kNoTrace; t = trace[t].parent) {
+                    result.solution.push_back(trace[t].action);
+                }
+                std::reverse(result.solution.begin(), result.solution.end());
+                break;
+            }
+            if (!info.is_terminal) {
+                candidates.push_back({scores[slot], info.hash, slot, children[slot].get_agent_index()});
+            }
+        }
+        if (result.solved) {
+            break;
+        }
+
+        // Keep the best child of each hash, then take the best first, skipping children of crowded agent cells
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+            return a.hash != b.hash ? a.hash < b.hash : a.score < b.score;
+        });
+        candidates.erase(std::unique(candidates.begin(), candidates.end(),
+                                     [](const Candidate &a, const Candidate &b) { return a.hash == b.hash; }),
+                         candidates.end());
+        std::sort(candidates.begin(), candidates.end(), better);
+        std::size_t next_size = 0;
+        for (const auto &candidate : candidates) {
+            if (next_size == width) {
+                break;
+            }
+            if (options.bucket_size > 0 && bucket_counts[candidate.agent_idx] >= options.bucket_size) {
+                continue;
+            }
+            ++bucket_counts[candidate.agent_idx];
+            const std::size_t parent = candidate.slot / kNumChildren;
+            std::swap(next_beam[next_size], children[candidate.slot]);
+            next_returns[next_size] = returns[parent] + infos[candidate.slot].reward;
+            trace.push_back({traces[parent], RNDGameState::ALL_ACTIONS[candidate.slot % kNumChildren]});
+            next_traces[next_size] = trace.size() - 1;
+            ++next_size;
+        }
+        for (const auto &candidate : candidates) {
+            bucket_counts[candidate.agent_idx] = 0;
+        }
+        std::swap(beam, next_beam);
+        std::swap(returns, next_returns);
+        std::swap(traces, next_traces);
+        beam_size = next_size;
+    }
+    // The loop also ends when every child is terminal, which exhausts the beam rather than hitting the depth limit
+    result.hit_limit = !result.solved && beam_size > 0;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
+}    // namespace stonesngems
@@ -0,0 +1,36 @@
+#ifndef STONESNGEMS_BEAM_SEARCH_H_
+#define STONESNGEMS_BEAM_SEARCH_H_
+
+#include <cstddef>
+
+#include "hda_solver.h"
+#include "search_result.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+struct BeamOptions {
+    std::size_t beam_width = 1024;    // Number of states kept per layer
+    std::size_t max_depth = 2000;     // Maximum number of layers to search
+    std::size_t bucket_size = 8;      // Maximum states with the same agent cell kept per layer, 0 for no limit
+    std::size_t num_threads = 1;      // Number of worker threads, 0 uses the hardware concurrency
+    HeuristicFunction heuristic;      // Score to minimise, empty to rank by the reward collected so far
+};
+
+/**
+ * Search for a solution with beam search, keeping the best beam_width states of each layer.
+ * The beam and the children of a layer live in preallocated arrays of states: each state is expanded in parallel with
+ * expand_shared() into its own slots, the children are ranked by score through small index records, and the selected
+ * children are swapped into the next beam, so states are never copied for sorting and buffers are reused between
+ * layers. Children with the same hash as a better child of the layer are dropped, and at most bucket_size children
+ * per agent cell are kept so the beam does not collapse into near-identical states.
+ * @param state The root state
+ * @param options Search options
+ * @return The search result, with the solution if found
+ * @throws std::invalid_argument if beam_width is 0
+ */
+[[nodiscard]] auto beam_search(const RNDGameState &state, const BeamOptions &options = {}) -> SearchResult;
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_BEAM_SEARCH_H_
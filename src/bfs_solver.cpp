@@ -0,0 +1,169 @@
+#include "bfs_solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "definitions.h"
+#include "search_result.h"
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+namespace {
+constexpr std::size_t kBytesPerMB = 1024 * 1024;
+constexpr std::size_t kVisitedEntryBytes = 48;    // Approximate node size of the visited map
+
+// Edge into a visited state, used to walk back from the solution to the root
+struct ParentEdge {
+    uint64_t parent_hash;
+    Action action;
+};
+
+struct Child {
+    RNDGameState state;
+    uint64_t hash;
+    uint64_t parent_hash;
+    Action action;
+};
+
+// Frontier, visited set, and outgoing children owned by a single worker
+struct Partition {
+    std::vector<RNDGameState> frontier;
+    std::unordered_map<uint64_t, ParentEdge> visited;
+    std::vector<std::vector<Child>> outbox;    // Children generated by this worker, by destination partition
+    std::vector<Child> solutions;
+    std::size_t nodes_expanded = 0;
+    std::size_t nodes_generated = 0;
+};
+}    // namespace
+
+auto bfs_solve(const RNDGameState &state, const BFSOptions &options) -> SearchResult {
+    const auto start_time = std::chrono::steady_clock::now();
+    SearchResult result;
+    if (state.is_solution()) {
+        result.solved = true;
+        return result;
+    }
+    if (state.is_terminal()) {
+        return result;
+    }
+
+    const std::unique_ptr<ThreadPool> pool =
+        (options.num_threads == 1) ? nullptr : std::make_unique<ThreadPool>(options.num_threads);
+    const std::size_t num_partitions = pool ? pool->num_threads() : 1;
+    std::vector<Partition> partitions(num_partitions);
+    for (auto &partition : partitions) {
+        partition.outbox.resize(num_partitions);
+    }
+    const auto run = [&](const auto &func) {
+        if (pool) {
+            pool->run(func);
+        } else {
+            func(0);
+        }
+    };
+
+    const uint64_t root_hash = state.get_hash();
+    partitions[root_hash % num_partitions].visited.emplace(root_hash, ParentEdge{root_hash, Action::kNoop});
+    partitions[root_hash % num_partitions].frontier.push_back(state);
+    const std::size_t state_bytes = state.memory_bytes();
+
+    // Expand the frontier of a partition, routing children to the partition which owns their hash
+    const auto expand_partition = [&](std::size_t idx) {
+        Partition &partition = partitions[idx];
+        std::vector<Action> actions;
+        for (const auto &parent : partition.frontier) {
+            ++partition.nodes_expanded;
+            const uint64_t parent_hash = parent.get_hash();
+            parent.legal_actions(actions, options.prune_actions);
+            for (const auto action : actions) {
+                if (options.prune_actions && parent.is_action_fatal(action)) {
+                    continue;
+                }
+                RNDGameState child = parent;
+                child.apply_action(action);
+                ++partition.nodes_generated;
+                const uint64_t hash = child.get_hash();
+                if (child.is_solution()) {
+                    partition.solutions.push_back({std::move(child), hash, parent_hash, action});
+                    continue;
+                }
+                // Visited sets are read-only during expansion, so already seen children can be dropped here
+                const std::size_t dest = hash % num_partitions;
+                if (child.is_terminal() || partitions[dest].visited.count(hash) > 0) {
+                    continue;
+                }
+                partition.outbox[dest].push_back({std::move(child), hash, parent_hash, action});
+            }
+        }
+    };
+
+    // Merge the children sent to a partition into its visited set and next frontier
+    const auto merge_partition = [&](std::size_t idx) {
+        Partition &partition = partitions[idx];
+        partition.frontier.clear();
+        for (auto &sender : partitions) {
+            for (auto &child : sender.outbox[idx]) {
+                if (partition.visited.emplace(child.hash, ParentEdge{child.parent_hash, child.action}).second) {
+                    partition.frontier.push_back(std::move(child.state));
+                }
+            }
+            sender.outbox[idx].clear();
+        }
+    };
+
+    std::size_t depth = 0;
+    while (true) {
+        run(expand_partition);
+        ++depth;
+
+        // Solution found in this layer, walk the parent edges back to the root
+        const auto it = std::find_if(partitions.begin(), partitions.end(),
+                                     [](const Partition &partition) { return !partition.solutions.empty(); });
+        if (it != partitions.end()) {
+            const Child &solution = it->solutions.front();
+            result.solved = true;
+            result.solution.push_back(solution.action);
+            uint64_t hash = solution.parent_hash;
+            while (hash != root_hash) {
+                const ParentEdge &edge = partitions[hash % num_partitions].visited.at(hash);
+                result.solution.push_back(edge.action);
+                hash = edge.parent_hash;
+            }
+            std::reverse(result.solution.begin(), result.solution.end());
+            break;
+        }
+
+        run(merge_partition);
+        std::size_t frontier_size = 0;
+        std::size_t visited_size = 0;
+        for (const auto &partition : partitions) {
+            frontier_size += partition.frontier.size();
+            visited_size += partition.visited.size();
+        }
+        if (frontier_size == 0) {
+            break;
+        }
+        const std::size_t memory_bytes = visited_size * kVisitedEntryBytes + frontier_size * state_bytes;
+        if ((options.max_depth > 0 && depth >= options.max_depth) ||
+            (options.max_memory_mb > 0 && memory_bytes > options.max_memory_mb * kBytesPerMB)) {
+            result.hit_limit = true;
+            break;
+        }
+    }
+
+    for (const auto &partition : partitions) {
+        result.nodes_expanded += partition.nodes_expanded;
+        result.nodes_generated += partition.nodes_generated;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
+}    // namespace stonesngems
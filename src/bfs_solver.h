@@ -0,0 +1,32 @@
+#ifndef STONESNGEMS_BFS_SOLVER_H_
+#define STONESNGEMS_BFS_SOLVER_H_
+
+#include <cstddef>
+
+#include "search_result.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+struct BFSOptions {
+    std::size_t num_threads = 1;      // Number of worker threads, 0 uses the hardware concurrency
+    std::size_t max_depth = 0;        // Maximum number of layers to search, 0 for no limit
+    std::size_t max_memory_mb = 0;    // Estimated memory limit for the visited set and frontier, 0 for no limit
+    bool prune_actions = true;        // Skip actions equivalent to kNoop and actions which are certain to be fatal
+};
+
+/**
+ * Search for a shortest solution with a layer-synchronous parallel breadth-first search.
+ * States are identified by get_hash(). The frontier and visited set are partitioned by hash, one partition per
+ * worker: workers expand their own frontier and route each child to the partition owning its hash, then each worker
+ * merges the children sent to it into its visited set and next frontier. Visited sets are only read while expanding
+ * and only written by their owner while merging, so no locks are needed.
+ * @param state The root state
+ * @param options Search options
+ * @return The search result, with the solution if found
+ */
+[[nodiscard]] auto bfs_solve(const RNDGameState &state, const BFSOptions &options = {}) -> SearchResult;
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_BFS_SOLVER_H_
@@ -5,6 +5,7 @@
 
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <vector>
@@ -203,6 +204,13 @@ struct Element {
     }
 };
 
+// Cell which was written to during the last step, along with its type before the step
+struct ChangedCell {
+    std::size_t index;
+    HiddenCellType previous;
+    NOP_STRUCTURE(ChangedCell, index, previous);
+};
+
 struct Board {
     Board() = default;
     Board(std::size_t rows_, std::size_t cols_, int gems_required_, int max_steps_)
@@ -211,7 +219,8 @@ struct Board {
           max_steps(max_steps_),
           gems_required(gems_required_),
           grid(rows * cols, HiddenCellType::kNull),
-          has_updated(rows * cols, false) {}
+          has_updated(rows * cols, false),
+          has_changed(rows * cols, false) {}
 
     auto operator==(const Board &other) const -> bool {
         return grid == other.grid;
@@ -245,10 +254,11 @@ struct Board {
         return indices;
     }
 
-    void reset_updated() noexcept {
-        for (std::size_t i = 0; i < rows * cols; ++i) {
-            has_updated[i] = false;
-        }
+    // Forget the last step after loading a serialized board, which holds no updated or changed cells
+    void clear_step_state() noexcept {
+        has_updated.assign(rows * cols, 0);
+        has_changed.assign(rows * cols, 0);
+        changed_cells.clear();
     }
 
     // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
@@ -261,8 +271,65 @@ struct Board {
     int gems_required = -1;
     std::vector<HiddenCellType> grid;
     std::vector<uint8_t> has_updated;
+    std::vector<uint8_t> has_changed;
+    std::vector<ChangedCell> changed_cells;
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+    // has_updated is scratch of the board scan, and has_changed and changed_cells only describe the last step, so they
+    // are left out of the serialized format and rebuilt by clear_step_state() on load
+    NOP_STRUCTURE(Board, zorb_hash, rows, cols, agent_pos, agent_idx, max_steps, gems_required, grid);
+};
+
+// Cells of a board as the rules read and write them. Cell i is at i * stride, which is 1 for the vectors of a Board and
+// the number of instances for the interleaved boards of the BatchSimulator, so both are stepped by the same rules.
+struct BoardView {
+    BoardView() = default;
+    BoardView(HiddenCellType *grid_, uint8_t *has_updated_, uint8_t *has_changed_,
+              std::vector<ChangedCell> *changed_cells_, std::size_t stride_) noexcept
+        : grid(grid_),
+          has_updated(has_updated_),
+          has_changed(has_changed_),
+          changed_cells(changed_cells_),
+          stride(stride_) {}
+    explicit BoardView(Board &board) noexcept
+        : BoardView(board.grid.data(), board.has_updated.data(), board.has_changed.data(), &board.changed_cells, 1) {}
+
+    [[nodiscard]] auto item(std::size_t index) noexcept -> HiddenCellType & {
+        return grid[index * stride];    // NOLINT(*-pointer-arithmetic)
+    }
+
+    [[nodiscard]] auto item(std::size_t index) const noexcept -> HiddenCellType {
+        return grid[index * stride];    // NOLINT(*-pointer-arithmetic)
+    }
+
+    [[nodiscard]] auto updated(std::size_t index) noexcept -> uint8_t & {
+        return has_updated[index * stride];    // NOLINT(*-pointer-arithmetic)
+    }
+
+    // Record the cell as changed, must be called before the cell is written to
+    void mark_changed(std::size_t index) noexcept {
+        uint8_t &changed = has_changed[index * stride];    // NOLINT(*-pointer-arithmetic)
+        if (!changed) {
+            changed = true;
+            changed_cells->push_back({index, item(index)});
+        }
+    }
+
+    // Clear the changed and updated flags, only cells which were written to can have their updated flag set
+    void reset_changed() noexcept {
+        for (const auto &changed : *changed_cells) {
+            has_changed[changed.index * stride] = false;    // NOLINT(*-pointer-arithmetic)
+            has_updated[changed.index * stride] = false;    // NOLINT(*-pointer-arithmetic)
+        }
+        changed_cells->clear();
+    }
+
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    HiddenCellType *grid = nullptr;
+    uint8_t *has_updated = nullptr;
+    uint8_t *has_changed = nullptr;
+    std::vector<ChangedCell> *changed_cells = nullptr;
+    std::size_t stride = 1;
     // NOLINTEND(misc-non-private-member-variables-in-classes)
-    NOP_STRUCTURE(Board, zorb_hash, rows, cols, agent_pos, agent_idx, max_steps, gems_required, grid, has_updated);
 };
 
 }    // namespace stonesngems
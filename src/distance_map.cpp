@@ -0,0 +1,175 @@
+#include "distance_map.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "definitions.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+namespace {
+constexpr std::size_t kWordBits = 64;
+
+// Cells the agent moves onto: empty and dirt, the agent itself, and the collectables it walks over
+constexpr auto make_walkable_table() noexcept -> std::array<bool, kNumHiddenCellType> {
+    std::array<bool, kNumHiddenCellType> table{};
+    for (const auto element : {HiddenCellType::kAgent, HiddenCellType::kEmpty, HiddenCellType::kDirt,
+                               HiddenCellType::kDiamond, HiddenCellType::kDiamondFalling, HiddenCellType::kExitOpen,
+                               HiddenCellType::kAgentInExit, HiddenCellType::kKeyRed, HiddenCellType::kKeyBlue,
+                               HiddenCellType::kKeyGreen, HiddenCellType::kKeyYellow}) {
+        table[static_cast<std::size_t>(element)] = true;    // NOLINT(*-bounds-constant-array-index)
+    }
+    return table;
+}
+constexpr std::array<bool, kNumHiddenCellType> kWalkable = make_walkable_table();
+
+// dst |= src moved k cells towards higher indices
+void or_shifted_up(const std::vector<uint64_t> &src, std::size_t k, std::vector<uint64_t> &dst) noexcept {
+    const std::size_t word_shift = k / kWordBits;
+    const std::size_t bit_shift = k % kWordBits;
+    for (std::size_t i = dst.size(); i-- > word_shift;) {
+        uint64_t value = src[i - word_shift] << bit_shift;
+        if (bit_shift != 0 && i > word_shift) {
+            value |= src[i - word_shift - 1] >> (kWordBits - bit_shift);
+        }
+        dst[i] |= value;
+    }
+}
+
+// dst |= src moved k cells towards lower indices
+void or_shifted_down(const std::vector<uint64_t> &src, std::size_t k, std::vector<uint64_t> &dst) noexcept {
+    const std::size_t word_shift = k / kWordBits;
+    const std::size_t bit_shift = k % kWordBits;
+    for (std::size_t i = 0; i + word_shift < dst.size(); ++i) {
+        uint64_t value = src[i + word_shift] >> bit_shift;
+        if (bit_shift != 0 && i + word_shift + 1 < dst.size()) {
+            value |= src[i + word_shift + 1] << (kWordBits - bit_shift);
+        }
+        dst[i] |= value;
+    }
+}
+
+auto mix_word(uint64_t hash, uint64_t word) noexcept -> uint64_t {
+    hash ^= word + 0x9E3779B97F4A7C15 + (hash << 6) + (hash >> 2);    // NOLINT(*-magic-numbers)
+    return hash;
+}
+}    // namespace
+
+auto DistanceMap::same_terrain(const DistanceMap &other) const noexcept -> bool {
+    return terrain_hash == other.terrain_hash && rows == other.rows && cols == other.cols &&
+           walkable == other.walkable && target_cells == other.target_cells;
+}
+
+void DistanceMap::SetTerrain(const RNDGameState &state, const std::vector<HiddenCellType> &targets) noexcept {
+    std::array<bool, kNumHiddenCellType> is_target{};
+    for (const auto element : targets) {
+        is_target[static_cast<std::size_t>(element)] = true;    // NOLINT(*-bounds-constant-array-index)
+    }
+    const auto shape = state.observation_shape();
+    const std::size_t num_words = (shape[1] * shape[2] + kWordBits - 1) / kWordBits;
+    if (rows != shape[1] || cols != shape[2]) {
+        rows = shape[1];
+        cols = shape[2];
+        not_first_col.assign(num_words, 0);
+        not_last_col.assign(num_words, 0);
+        for (std::size_t i = 0; i < rows * cols; ++i) {
+            const uint64_t bit = uint64_t{1} << (i % kWordBits);
+            not_first_col[i / kWordBits] |= (i % cols != 0) ? bit : 0;
+            not_last_col[i / kWordBits] |= (i % cols != cols - 1) ? bit : 0;
+        }
+    }
+    walkable.assign(num_words, 0);
+    target_cells.assign(num_words, 0);
+    for (std::size_t i = 0; i < rows * cols; ++i) {
+        const auto element = static_cast<std::size_t>(state.get_hidden_item(i));
+        const uint64_t bit = uint64_t{1} << (i % kWordBits);
+        walkable[i / kWordBits] |= kWalkable[element] ? bit : 0;      // NOLINT(*-bounds-constant-array-index)
+        target_cells[i / kWordBits] |= is_target[element] ? bit : 0;    // NOLINT(*-bounds-constant-array-index)
+    }
+    terrain_hash = mix_word(rows, cols);
+    for (std::size_t w = 0; w < num_words; ++w) {
+        terrain_hash = mix_word(mix_word(terrain_hash, walkable[w]), target_cells[w]);
+    }
+}
+
+void DistanceMap::Search() noexcept {
+    // Multi-source BFS from all targets at once, one layer per loop with the frontier as a bitset: each layer is a few
+    // shifted ORs over the board words, and only the newly reached cells are visited individually
+    const std::size_t num_words = walkable.size();
+    distances.assign(rows * cols, kUnreachable);
+    frontier = target_cells;
+    visited = target_cells;
+    next.resize(num_words);
+    scratch.resize(num_words);
+    for (int distance = 0;; ++distance) {
+        bool any = false;
+        for (std::size_t w = 0; w < num_words; ++w) {
+            for (uint64_t bits = frontier[w]; bits != 0; bits &= bits - 1) {
+                distances[w * kWordBits + static_cast<std::size_t>(__builtin_ctzll(bits))] = distance;
+            }
+            any = any || frontier[w] != 0;
+        }
+        if (!any) {
+            break;
+        }
+        std::fill(next.begin(), next.end(), 0);
+        for (std::size_t w = 0; w < num_words; ++w) {
+            scratch[w] = frontier[w] & not_last_col[w];
+        }
+        or_shifted_up(scratch, 1, next);
+        for (std::size_t w = 0; w < num_words; ++w) {
+            scratch[w] = frontier[w] & not_first_col[w];
+        }
+        or_shifted_down(scratch, 1, next);
+        or_shifted_up(frontier, cols, next);
+        or_shifted_down(frontier, cols, next);
+        for (std::size_t w = 0; w < num_words; ++w) {
+            next[w] &= walkable[w] & ~visited[w];
+            visited[w] |= next[w];
+        }
+        std::swap(frontier, next);
+    }
+}
+
+DistanceMapCache::DistanceMapCache(std::size_t capacity) : entries(capacity), occupied(capacity, false) {
+    if (capacity == 0) {
+        throw std::invalid_argument("capacity must be positive");
+    }
+}
+
+auto DistanceMapCache::get(const RNDGameState &state, const std::vector<HiddenCellType> &targets) noexcept
+    -> const DistanceMap & {
+    probe.SetTerrain(state, targets);
+    const std::size_t slot = probe.terrain_hash % entries.size();
+    DistanceMap &entry = entries[slot];
+    if (occupied[slot] && entry.same_terrain(probe)) {
+        ++num_hits;
+        return entry;
+    }
+    ++num_misses;
+    // Hand the probe terrain to the entry and keep the old entry buffers for the next probe
+    std::swap(entry.walkable, probe.walkable);
+    std::swap(entry.target_cells, probe.target_cells);
+    if (entry.rows != probe.rows || entry.cols != probe.cols) {
+        entry.rows = probe.rows;
+        entry.cols = probe.cols;
+        entry.not_first_col = probe.not_first_col;
+        entry.not_last_col = probe.not_last_col;
+    }
+    entry.terrain_hash = probe.terrain_hash;
+    entry.Search();
+    occupied[slot] = true;
+    return entry;
+}
+
+void DistanceMapCache::clear() noexcept {
+    std::fill(occupied.begin(), occupied.end(), false);
+}
+
+}    // namespace stonesngems
@@ -0,0 +1,126 @@
+#ifndef STONESNGEMS_DISTANCE_MAP_H_
+#define STONESNGEMS_DISTANCE_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "definitions.h"
+
+namespace stonesngems {
+
+class RNDGameState;
+
+// Shortest walking distance of every cell to the nearest target cell, filled by RNDGameState::get_distance_map().
+// The map also holds the terrain it was computed on (the cells the agent can walk on and the target cells) as bitsets,
+// and the scratch bitsets of the search, so refilling a map reuses all of its buffers.
+class DistanceMap {
+public:
+    static constexpr int kUnreachable = -1;
+
+    /**
+     * Get the distance of the given cell to the nearest target.
+     * @param index The flat index of the cell
+     * @return Number of moves, or kUnreachable if no target can be reached from the cell
+     */
+    [[nodiscard]] auto distance(std::size_t index) const noexcept -> int {
+        return distances[index];
+    }
+
+    /**
+     * Get the distances of all cells to the nearest target.
+     * @return Flat vector of distances, kUnreachable for cells which cannot reach a target
+     */
+    [[nodiscard]] auto get_distances() const noexcept -> const std::vector<int> & {
+        return distances;
+    }
+
+    /**
+     * Get the hash of the terrain the map was computed on.
+     * @return hash of the walkable and target cells
+     */
+    [[nodiscard]] auto get_terrain_hash() const noexcept -> uint64_t {
+        return terrain_hash;
+    }
+
+    /**
+     * Check if the map was computed on the same terrain as another map, in which case their distances are equal.
+     * @param other The map to compare against
+     * @return True if the walkable and target cells of both maps are the same
+     */
+    [[nodiscard]] auto same_terrain(const DistanceMap &other) const noexcept -> bool;
+
+    friend class RNDGameState;
+    friend class DistanceMapCache;
+
+private:
+    void SetTerrain(const RNDGameState &state, const std::vector<HiddenCellType> &targets) noexcept;
+    void Search() noexcept;
+
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    uint64_t terrain_hash = 0;
+    std::vector<uint64_t> walkable;         // Cells the agent can walk onto
+    std::vector<uint64_t> target_cells;     // Cells holding a target element
+    std::vector<uint64_t> frontier;         // Cells reached in the current BFS layer
+    std::vector<uint64_t> next;             // Cells reached in the next BFS layer
+    std::vector<uint64_t> visited;          // Cells reached in any BFS layer
+    std::vector<uint64_t> scratch;          // Frontier masked for horizontal moves
+    std::vector<uint64_t> not_first_col;    // Cells which have a neighbour to the left
+    std::vector<uint64_t> not_last_col;     // Cells which have a neighbour to the right
+    std::vector<int> distances;
+};
+
+// Direct mapped cache of distance maps keyed by terrain, so states which only differ in the agent position, dug dirt or
+// anything else off the walkable terrain share one search. Entries are reused in place, so a warm cache does not
+// allocate. The cache is not thread safe, use one per thread.
+class DistanceMapCache {
+public:
+    /**
+     * Create an empty cache.
+     * @param capacity Number of maps held
+     * @throws std::invalid_argument if capacity is 0
+     */
+    explicit DistanceMapCache(std::size_t capacity = 64);
+
+    /**
+     * Get the distance map of the state towards the target elements, computing it only if no map of the same terrain
+     * is held.
+     * @note The returned map is valid until the next call to get()
+     * @param state The state to compute distances on
+     * @param targets The hidden elements to compute distances to
+     * @return The distance map
+     */
+    [[nodiscard]] auto get(const RNDGameState &state, const std::vector<HiddenCellType> &targets) noexcept
+        -> const DistanceMap &;
+
+    /**
+     * Get the number of calls to get() answered from the cache.
+     */
+    [[nodiscard]] auto hits() const noexcept -> std::size_t {
+        return num_hits;
+    }
+
+    /**
+     * Get the number of calls to get() which needed a search.
+     */
+    [[nodiscard]] auto misses() const noexcept -> std::size_t {
+        return num_misses;
+    }
+
+    /**
+     * Drop all held maps.
+     */
+    void clear() noexcept;
+
+private:
+    DistanceMap probe;
+    std::vector<DistanceMap> entries;
+    std::vector<bool> occupied;
+    std::size_t num_hits = 0;
+    std::size_t num_misses = 0;
+};
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_DISTANCE_MAP_H_
@@ -0,0 +1,77 @@
+#include "expand.h"
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "definitions.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+namespace {
+auto make_child_info(const RNDGameState &child) noexcept -> ChildInfo {
+    return {child.get_hash(), child.get_reward_signal(), child.get_current_reward(), child.is_terminal(),
+            child.is_solution()};
+}
+}    // namespace
+
+void expand(const RNDGameState &state, RNDGameState *children, ChildInfo *infos) noexcept {
+    // NOLINTBEGIN(*-pointer-arithmetic)
+    for (std::size_t i = 0; i < kNumChildren; ++i) {
+        RNDGameState &child = children[i];
+        child = state;
+        child.apply_action(ALL_ACTIONS[i]);    // NOLINT(*-bounds-constant-array-index)
+        infos[i] = make_child_info(child);
+    }
+    // NOLINTEND(*-pointer-arithmetic)
+}
+
+void expand(const RNDGameState &state, std::vector<RNDGameState> &children, std::vector<ChildInfo> &infos) noexcept {
+    if (children.size() < kNumChildren) {
+        children.resize(kNumChildren, state);
+    }
+    if (infos.size() < kNumChildren) {
+        infos.resize(kNumChildren);
+    }
+    expand(state, children.data(), infos.data());
+}
+
+void expand_shared(const RNDGameState &state, RNDGameState *children, ChildInfo *infos) noexcept {
+    assert(ALL_ACTIONS[0] == Action::kNoop);
+    // NOLINTBEGIN(*-pointer-arithmetic)
+    // The kNoop child is simulated in full, the other children reuse its world update whenever the agent's move
+    // cannot be observed by the rest of the tick
+    RNDGameState &noop_child = children[0];
+    noop_child = state;
+    noop_child.apply_action(Action::kNoop);
+    infos[0] = make_child_info(noop_child);
+    for (std::size_t i = 1; i < kNumChildren; ++i) {
+        const Action action = ALL_ACTIONS[i];    // NOLINT(*-bounds-constant-array-index)
+        const Direction direction = action_to_direction(action);
+        RNDGameState &child = children[i];
+        if (state.IsAgentBlocked(direction)) {
+            child = noop_child;
+        } else if (state.IsAgentMoveIsolated(direction)) {
+            child.ApplyIsolatedMove(noop_child, direction);
+        } else {
+            child = state;
+            child.apply_action(action);
+        }
+        infos[i] = make_child_info(child);
+    }
+    // NOLINTEND(*-pointer-arithmetic)
+}
+
+void expand_shared(const RNDGameState &state, std::vector<RNDGameState> &children,
+                   std::vector<ChildInfo> &infos) noexcept {
+    if (children.size() < kNumChildren) {
+        children.resize(kNumChildren, state);
+    }
+    if (infos.size() < kNumChildren) {
+        infos.resize(kNumChildren);
+    }
+    expand_shared(state, children.data(), infos.data());
+}
+
+}    // namespace stonesngems
@@ -0,0 +1,65 @@
+#ifndef STONESNGEMS_EXPAND_H_
+#define STONESNGEMS_EXPAND_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "definitions.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+// Number of children produced by an expansion, one per action in ALL_ACTIONS order
+constexpr std::size_t kNumChildren = kNumActions;
+
+// Summary of a child state, so search code can filter children without touching the states themselves
+struct ChildInfo {
+    uint64_t hash = 0;
+    uint64_t reward_signal = 0;
+    int reward = 0;
+    bool is_terminal = false;
+    bool is_solution = false;
+};
+
+/**
+ * Expand all children of a state into preallocated outputs.
+ * Children are copy-assigned from the parent, so states which already hold a board of the same size reuse their
+ * buffers and the expansion does not allocate.
+ * @param state The parent state
+ * @param children Pointer to kNumChildren states to write the children into, child i is the result of ALL_ACTIONS[i]
+ * @param infos Pointer to kNumChildren child summaries
+ */
+void expand(const RNDGameState &state, RNDGameState *children, ChildInfo *infos) noexcept;
+
+/**
+ * Expand all children of a state into reused vectors.
+ * @param state The parent state
+ * @param children Vector of states to write the children into, resized to kNumChildren if needed
+ * @param infos Vector of child summaries, resized to kNumChildren if needed
+ */
+void expand(const RNDGameState &state, std::vector<RNDGameState> &children, std::vector<ChildInfo> &infos) noexcept;
+
+/**
+ * Expand all children of a state, simulating the world update once and sharing it between children.
+ * The kNoop child is simulated in full. Children whose action is blocked are copies of it, and children where the agent
+ * walks onto empty or dirt with no updating element within two cells are patched from it. All other children fall back
+ * to apply_action, so the children are identical to those of expand().
+ * @param state The parent state
+ * @param children Pointer to kNumChildren states to write the children into, child i is the result of ALL_ACTIONS[i]
+ * @param infos Pointer to kNumChildren child summaries
+ */
+void expand_shared(const RNDGameState &state, RNDGameState *children, ChildInfo *infos) noexcept;
+
+/**
+ * Expand all children of a state into reused vectors, sharing the world update between children.
+ * @param state The parent state
+ * @param children Vector of states to write the children into, resized to kNumChildren if needed
+ * @param infos Vector of child summaries, resized to kNumChildren if needed
+ */
+void expand_shared(const RNDGameState &state, std::vector<RNDGameState> &children,
+                   std::vector<ChildInfo> &infos) noexcept;
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_EXPAND_H_
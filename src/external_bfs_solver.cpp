@@ -0,0 +1,381 @@
+#include "external_bfs_solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <optional>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "definitions.h"
+#include "search_result.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr std::size_t kBytesPerMB = 1024 * 1024;
+constexpr std::size_t kRecordOverhead = 64;    // Approximate in-memory size of a buffered record besides its data
+constexpr std::size_t kClosedEntrySize = 2 * sizeof(uint64_t) + sizeof(uint8_t);
+
+// Packed state with the edge it was generated through
+struct Record {
+    uint64_t hash;
+    uint64_t parent_hash;
+    Action action;
+    std::vector<uint8_t> data;
+};
+
+// Visited state and the edge it was first reached through, fixed size on disk so the file can be binary searched
+struct ClosedEntry {
+    uint64_t hash;
+    uint64_t parent_hash;
+    Action action;
+};
+
+template <typename T>
+void write_value(std::ostream &out, const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));    // NOLINT(*-reinterpret-cast)
+}
+
+template <typename T>
+auto read_value(std::istream &in, T &value) -> bool {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));    // NOLINT(*-reinterpret-cast)
+}
+
+void write_record(std::ostream &out, const Record &record) {
+    write_value(out, record.hash);
+    write_value(out, record.parent_hash);
+    write_value(out, static_cast<uint8_t>(record.action));
+    write_value(out, static_cast<uint32_t>(record.data.size()));
+    out.write(reinterpret_cast<const char *>(record.data.data()),    // NOLINT(*-reinterpret-cast)
+              static_cast<std::streamsize>(record.data.size()));
+}
+
+auto read_record(std::istream &in, Record &record) -> bool {
+    uint8_t action = 0;
+    uint32_t size = 0;
+    if (!read_value(in, record.hash) || !read_value(in, record.parent_hash) || !read_value(in, action) ||
+        !read_value(in, size)) {
+        return false;
+    }
+    record.action = static_cast<Action>(action);
+    record.data.resize(size);
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(record.data.data()),    // NOLINT(*-reinterpret-cast)
+                                     static_cast<std::streamsize>(size)));
+}
+
+void write_closed(std::ostream &out, const ClosedEntry &entry) {
+    write_value(out, entry.hash);
+    write_value(out, entry.parent_hash);
+    write_value(out, static_cast<uint8_t>(entry.action));
+}
+
+auto read_closed(std::istream &in, ClosedEntry &entry) -> bool {
+    uint8_t action = 0;
+    if (!read_value(in, entry.hash) || !read_value(in, entry.parent_hash) || !read_value(in, action)) {
+        return false;
+    }
+    entry.action = static_cast<Action>(action);
+    return true;
+}
+
+auto open_output(const fs::path &path) -> std::ofstream {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Unable to create " + path.string());
+    }
+    return out;
+}
+
+auto open_input(const fs::path &path) -> std::ifstream {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Unable to open " + path.string());
+    }
+    return in;
+}
+
+void check_written(const std::ofstream &out, const fs::path &path) {
+    if (!out) {
+        throw std::runtime_error("Unable to write " + path.string());
+    }
+}
+
+// Sort records by hash, drop duplicates within the run, and write them out
+auto write_run(const fs::path &path, std::vector<Record> records) -> std::size_t {
+    std::sort(records.begin(), records.end(), [](const Record &a, const Record &b) { return a.hash < b.hash; });
+    const auto last = std::unique(records.begin(), records.end(),
+                                  [](const Record &a, const Record &b) { return a.hash == b.hash; });
+    std::ofstream out = open_output(path);
+    std::for_each(records.begin(), last, [&out](const Record &record) { write_record(out, record); });
+    out.flush();
+    check_written(out, path);
+    return static_cast<std::size_t>(out.tellp());
+}
+
+// Uniquely named directory which is removed with everything in it when destroyed
+class WorkDir {
+public:
+    explicit WorkDir(const std::string &base) {
+        const fs::path parent = base.empty() ? fs::temp_directory_path() : fs::path(base);
+        std::random_device rd;
+        do {
+            path = parent / ("sng_external_bfs_" + std::to_string(rd()));
+        } while (!fs::create_directories(path));
+    }
+    WorkDir(const WorkDir &) = delete;
+    WorkDir(WorkDir &&) = delete;
+    auto operator=(const WorkDir &) -> WorkDir & = delete;
+    auto operator=(WorkDir &&) -> WorkDir & = delete;
+    ~WorkDir() {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    fs::path path;
+};
+
+// Writes sorted runs on a background thread, so the next buffer can be filled while the previous one is written
+class RunWriter {
+public:
+    RunWriter(fs::path dir, std::string prefix) : dir(std::move(dir)), prefix(std::move(prefix)) {}
+    RunWriter(const RunWriter &) = delete;
+    RunWriter(RunWriter &&) = delete;
+    auto operator=(const RunWriter &) -> RunWriter & = delete;
+    auto operator=(RunWriter &&) -> RunWriter & = delete;
+    ~RunWriter() {
+        if (pending.valid()) {
+            pending.wait();
+        }
+    }
+
+    void Submit(std::vector<Record> records) {
+        Wait();
+        runs.push_back(dir / (prefix + std::to_string(runs.size())));
+        pending = std::async(std::launch::async, write_run, runs.back(), std::move(records));
+    }
+
+    // Wait for the last run, rethrowing any error from the writer
+    auto Finish() -> const std::vector<fs::path> & {
+        Wait();
+        return runs;
+    }
+
+    [[nodiscard]] auto bytes_written() const noexcept -> std::size_t {
+        return bytes;
+    }
+
+private:
+    void Wait() {
+        if (pending.valid()) {
+            bytes += pending.get();
+        }
+    }
+
+    fs::path dir;
+    std::string prefix;
+    std::vector<fs::path> runs;
+    std::future<std::size_t> pending;
+    std::size_t bytes = 0;
+};
+
+struct RunReader {
+    std::ifstream in;
+    Record record;
+};
+
+// Merge the runs of a layer against the visited hashes, writing the new states as the next frontier and the merged
+// visited hashes as the next closed file. Returns the number of new states.
+auto merge_layer(const std::vector<fs::path> &runs, const fs::path &closed_path, const fs::path &frontier_out_path,
+                 const fs::path &closed_out_path) -> std::size_t {
+    std::vector<RunReader> readers;
+    readers.reserve(runs.size());
+    using HeapItem = std::pair<uint64_t, std::size_t>;
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<>> heap;
+    for (const auto &run : runs) {
+        readers.push_back({open_input(run), {}});
+        if (read_record(readers.back().in, readers.back().record)) {
+            heap.emplace(readers.back().record.hash, readers.size() - 1);
+        }
+    }
+    std::ifstream closed_in = open_input(closed_path);
+    std::ofstream closed_out = open_output(closed_out_path);
+    std::ofstream frontier_out = open_output(frontier_out_path);
+
+    ClosedEntry closed{};
+    bool has_closed = read_closed(closed_in, closed);
+    std::optional<uint64_t> last_hash;
+    std::size_t num_new = 0;
+    while (!heap.empty()) {
+        const std::size_t idx = heap.top().second;
+        heap.pop();
+        Record &record = readers[idx].record;
+        if (last_hash != record.hash) {
+            last_hash = record.hash;
+            while (has_closed && closed.hash < record.hash) {
+                write_closed(closed_out, closed);
+                has_closed = read_closed(closed_in, closed);
+            }
+            if (!has_closed || closed.hash != record.hash) {
+                write_closed(closed_out, {record.hash, record.parent_hash, record.action});
+                write_record(frontier_out, record);
+                ++num_new;
+            }
+        }
+        if (read_record(readers[idx].in, record)) {
+            heap.emplace(record.hash, idx);
+        }
+    }
+    while (has_closed) {
+        write_closed(closed_out, closed);
+        has_closed = read_closed(closed_in, closed);
+    }
+    closed_out.flush();
+    frontier_out.flush();
+    check_written(closed_out, closed_out_path);
+    check_written(frontier_out, frontier_out_path);
+    return num_new;
+}
+
+// Binary search the sorted closed file for a visited hash
+auto find_closed(const fs::path &closed_path, uint64_t hash) -> ClosedEntry {
+    std::ifstream in = open_input(closed_path);
+    std::size_t low = 0;
+    std::size_t high = fs::file_size(closed_path) / kClosedEntrySize;
+    ClosedEntry entry{};
+    while (low < high) {
+        const std::size_t mid = low + (high - low) / 2;
+        in.seekg(static_cast<std::streamoff>(mid * kClosedEntrySize));
+        if (!read_closed(in, entry)) {
+            break;
+        }
+        if (entry.hash == hash) {
+            return entry;
+        }
+        (entry.hash < hash) ? (low = mid + 1) : (high = mid);
+    }
+    throw std::runtime_error("Visited state missing from " + closed_path.string());
+}
+}    // namespace
+
+auto external_bfs_solve(const RNDGameState &state, const ExternalBFSOptions &options) -> SearchResult {
+    if (options.run_memory_mb == 0) {
+        throw std::invalid_argument("run_memory_mb must be positive");
+    }
+    const auto start_time = std::chrono::steady_clock::now();
+    SearchResult result;
+    if (state.is_solution()) {
+        result.solved = true;
+        return result;
+    }
+    if (state.is_terminal()) {
+        return result;
+    }
+
+    const WorkDir work_dir(options.work_dir);
+    const auto layer_path = [&work_dir](const std::string &name, std::size_t depth) {
+        return work_dir.path / (name + "_" + std::to_string(depth));
+    };
+    const uint64_t root_hash = state.get_hash();
+    {
+        std::ofstream frontier_out = open_output(layer_path("frontier", 0));
+        write_record(frontier_out, {root_hash, root_hash, Action::kNoop, state.serialize_local()});
+        std::ofstream closed_out = open_output(layer_path("closed", 0));
+        write_closed(closed_out, {root_hash, root_hash, Action::kNoop});
+    }
+
+    const std::size_t run_bytes = options.run_memory_mb * kBytesPerMB;
+    RNDGameState parent = state;    // Shares the game parameters, the board is loaded from each frontier record
+    std::vector<Action> actions;
+    std::optional<ClosedEntry> goal;
+    std::size_t depth = 0;
+    while (true) {
+        RunWriter writer(work_dir.path, "run_" + std::to_string(depth) + "_");
+        std::vector<Record> buffer;
+        std::size_t buffer_bytes = 0;
+        std::ifstream frontier_in = open_input(layer_path("frontier", depth));
+        Record record;
+        while (!goal && read_record(frontier_in, record)) {
+            parent.deserialize_local(record.data);
+            ++result.nodes_expanded;
+            parent.legal_actions(actions, options.prune_actions);
+            for (const auto action : actions) {
+                if (options.prune_actions && parent.is_action_fatal(action)) {
+                    continue;
+                }
+                RNDGameState child = parent;
+                child.apply_action(action);
+                ++result.nodes_generated;
+                if (child.is_solution()) {
+                    goal = ClosedEntry{child.get_hash(), record.hash, action};
+                    break;
+                }
+                if (child.is_terminal()) {
+                    continue;
+                }
+                buffer.push_back({child.get_hash(), record.hash, action, child.serialize_local()});
+                buffer_bytes += buffer.back().data.size() + kRecordOverhead;
+                if (buffer_bytes >= run_bytes) {
+                    writer.Submit(std::move(buffer));
+                    buffer = {};
+                    buffer_bytes = 0;
+                }
+            }
+        }
+        if (!buffer.empty()) {
+            writer.Submit(std::move(buffer));
+        }
+        const std::vector<fs::path> &runs = writer.Finish();
+        frontier_in.close();
+
+        // Solution found in this layer, walk the parent edges in the closed file back to the root
+        if (goal) {
+            result.solved = true;
+            result.solution.push_back(goal->action);
+            uint64_t hash = goal->parent_hash;
+            while (hash != root_hash) {
+                const ClosedEntry entry = find_closed(layer_path("closed", depth), hash);
+                result.solution.push_back(entry.action);
+                hash = entry.parent_hash;
+            }
+            std::reverse(result.solution.begin(), result.solution.end());
+            break;
+        }
+
+        const std::size_t num_new = merge_layer(runs, layer_path("closed", depth), layer_path("frontier", depth + 1),
+                                                layer_path("closed", depth + 1));
+        for (const auto &run : runs) {
+            fs::remove(run);
+        }
+        fs::remove(layer_path("frontier", depth));
+        fs::remove(layer_path("closed", depth));
+        ++depth;
+        if (num_new == 0) {
+            break;
+        }
+        const std::size_t disk_bytes = writer.bytes_written() + fs::file_size(layer_path("frontier", depth)) +
+                                       fs::file_size(layer_path("closed", depth));
+        if ((options.max_depth > 0 && depth >= options.max_depth) ||
+            (options.max_disk_mb > 0 && disk_bytes > options.max_disk_mb * kBytesPerMB)) {
+            result.hit_limit = true;
+            break;
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
+}    // namespace stonesngems
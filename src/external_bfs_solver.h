@@ -0,0 +1,37 @@
+#ifndef STONESNGEMS_EXTERNAL_BFS_SOLVER_H_
+#define STONESNGEMS_EXTERNAL_BFS_SOLVER_H_
+
+#include <cstddef>
+#include <string>
+
+#include "search_result.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+struct ExternalBFSOptions {
+    std::string work_dir;               // Directory for the layer and run files, empty uses the temporary directory
+    std::size_t run_memory_mb = 256;    // Memory for buffering children before they are written as a sorted run
+    std::size_t max_depth = 0;          // Maximum number of layers to search, 0 for no limit
+    std::size_t max_disk_mb = 0;        // Limit for the files of a layer, 0 for no limit
+    bool prune_actions = true;          // Skip actions equivalent to kNoop and actions which are certain to be fatal
+};
+
+/**
+ * Search for a shortest solution with an external-memory breadth-first search, for levels whose state space does not
+ * fit in memory. Each layer is stored on disk as states packed with RNDGameState::serialize_local(), sorted by
+ * get_hash(). Children of a layer are buffered in memory, sorted and written as run files by a background thread
+ * while generation continues. The runs are then merged, dropping duplicates within the layer and any state found in
+ * the sorted file of previously visited hashes, which also holds the parent edges used to rebuild the solution.
+ * @param state The root state
+ * @param options Search options
+ * @return The search result, with the solution if found
+ * @throws std::invalid_argument if run_memory_mb is 0
+ * @throws std::runtime_error if the work files cannot be created, written or read
+ */
+[[nodiscard]] auto external_bfs_solve(const RNDGameState &state, const ExternalBFSOptions &options = {})
+    -> SearchResult;
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_EXTERNAL_BFS_SOLVER_H_
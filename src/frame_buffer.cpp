@@ -0,0 +1,83 @@
+#include "frame_buffer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "definitions.h"
+#include "sprite_atlas.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+FrameBuffer::FrameBuffer(std::size_t tile_size) : tile_width(tile_size) {
+    if (!is_valid_tile_size(tile_size)) {
+        throw std::invalid_argument(std::string("Unsupported tile size: ") + std::to_string(tile_size));
+    }
+}
+
+FrameBuffer::FrameBuffer(const RNDGameState &state, std::size_t tile_size) : FrameBuffer(tile_size) {
+    render(state);
+}
+
+auto FrameBuffer::render(const RNDGameState &state) -> const std::vector<uint8_t> & {
+    const auto shape = state.image_shape(tile_width);
+    const std::size_t img_size = shape[0] * shape[1] * shape[2];
+    if (img_buffer.size() != img_size) {
+        invalidate();
+        img_buffer.resize(img_size);
+    }
+    UpdateTiles(state, img_buffer.data());
+    return img_buffer;
+}
+
+void FrameBuffer::render(const RNDGameState &state, uint8_t *img) {
+    UpdateTiles(state, img);
+}
+
+auto FrameBuffer::frame() const noexcept -> const std::vector<uint8_t> & {
+    return img_buffer;
+}
+
+auto FrameBuffer::image_shape() const noexcept -> std::array<std::size_t, 3> {
+    return {rows * tile_width, cols * tile_width, SPRITE_CHANNELS};
+}
+
+auto FrameBuffer::tile_size() const noexcept -> std::size_t {
+    return tile_width;
+}
+
+auto FrameBuffer::num_tiles_drawn() const noexcept -> std::size_t {
+    return tiles_drawn;
+}
+
+void FrameBuffer::invalidate() noexcept {
+    std::fill(tiles.begin(), tiles.end(), VisibleCellType::kNull);
+}
+
+void FrameBuffer::UpdateTiles(const RNDGameState &state, uint8_t *img) {
+    const auto shape = state.image_shape(tile_width);
+    const std::size_t state_rows = shape[0] / tile_width;
+    const std::size_t state_cols = shape[1] / tile_width;
+    // Board dimensions changed, nothing cached is valid
+    if (state_rows != rows || state_cols != cols) {
+        rows = state_rows;
+        cols = state_cols;
+        tiles.assign(rows * cols, VisibleCellType::kNull);
+    }
+    tiles_drawn = 0;
+    for (std::size_t i = 0; i < rows * cols; ++i) {
+        const VisibleCellType element = state.get_visible_item(i);
+        if (element != tiles[i]) {
+            tiles[i] = element;
+            draw_sprite(img, cols, i / cols, i % cols, element, tile_width);
+            ++tiles_drawn;
+        }
+    }
+}
+
+}    // namespace stonesngems
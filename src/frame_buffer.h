@@ -0,0 +1,90 @@
+#ifndef STONESNGEMS_FRAME_BUFFER_H_
+#define STONESNGEMS_FRAME_BUFFER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "definitions.h"
+#include "sprite_atlas.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+// Persistent image of a state which only repaints the tiles whose visible element changed since the last frame.
+class FrameBuffer {
+public:
+    /**
+     * Create an empty frame buffer.
+     * @param tile_size Tile width and height in pixels, one of SPRITE_TILE_SIZES
+     * @throws std::invalid_argument if the tile size is not supported
+     */
+    explicit FrameBuffer(std::size_t tile_size = SPRITE_WIDTH);
+
+    /**
+     * Create the frame buffer and render the initial frame of the given state.
+     * @param state The state to render
+     * @param tile_size Tile width and height in pixels, one of SPRITE_TILE_SIZES
+     * @throws std::invalid_argument if the tile size is not supported
+     */
+    explicit FrameBuffer(const RNDGameState &state, std::size_t tile_size = SPRITE_WIDTH);
+
+    /**
+     * Bring the owned frame up to date with the given state.
+     * @param state The state to render
+     * @return flattened byte vector represending RGB values (HWC)
+     */
+    auto render(const RNDGameState &state) -> const std::vector<uint8_t> &;
+
+    /**
+     * Bring an external frame up to date with the given state.
+     * The frame must hold whatever the previous call to this method wrote, otherwise call invalidate() first.
+     * @param state The state to render
+     * @param img Pointer to a buffer of at least rows * cols * tile_size * tile_size * SPRITE_CHANNELS bytes
+     */
+    void render(const RNDGameState &state, uint8_t *img);
+
+    /**
+     * Get the owned frame, as of the last call to render(state).
+     * @return flattened byte vector represending RGB values (HWC)
+     */
+    [[nodiscard]] auto frame() const noexcept -> const std::vector<uint8_t> &;
+
+    /**
+     * Get the shape of the frame.
+     * @return array indicating image HWC
+     */
+    [[nodiscard]] auto image_shape() const noexcept -> std::array<std::size_t, 3>;
+
+    /**
+     * Get the tile size the frame is rendered with.
+     * @return Tile width and height in pixels
+     */
+    [[nodiscard]] auto tile_size() const noexcept -> std::size_t;
+
+    /**
+     * Get the number of tiles repainted by the last render.
+     * @return Number of tiles
+     */
+    [[nodiscard]] auto num_tiles_drawn() const noexcept -> std::size_t;
+
+    /**
+     * Forget the cached tiles so that the next render repaints every tile.
+     */
+    void invalidate() noexcept;
+
+private:
+    void UpdateTiles(const RNDGameState &state, uint8_t *img);
+
+    std::size_t tile_width;
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::size_t tiles_drawn = 0;
+    std::vector<VisibleCellType> tiles;    // Element drawn in each tile, kNull if not yet drawn
+    std::vector<uint8_t> img_buffer;
+};
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_FRAME_BUFFER_H_
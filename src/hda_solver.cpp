@@ -0,0 +1,404 @@
+#include "hda_solver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "definitions.h"
+#include "mpmc_queue.h"
+#include "search_result.h"
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+namespace {
+constexpr std::size_t kBytesPerMB = 1024 * 1024;
+constexpr std::size_t kClosedEntryBytes = 64;    // Approximate closed map node plus parent record
+constexpr std::size_t kQueueCapacity = 4096;
+constexpr std::size_t kLimitCheckInterval = 256;
+constexpr std::size_t kNoWorker = std::numeric_limits<std::size_t>::max();
+constexpr int kNoIncumbent = std::numeric_limits<int>::max();
+
+// Location of a node record, the owning worker and the index in its record list
+struct NodeRef {
+    std::size_t worker;
+    std::size_t index;
+};
+
+// Edge into an accepted node, used to walk back from the solution to the root
+struct NodeRecord {
+    NodeRef parent;
+    Action action;
+};
+
+// Child sent to the worker which owns its hash
+struct Message {
+    RNDGameState state;
+    uint64_t hash;
+    NodeRef parent;
+    Action action;
+    int g;
+};
+
+// Lowest cost and most steps remaining a state has been accepted with
+struct Label {
+    int g;
+    int steps_remaining;
+};
+
+struct OpenNode {
+    RNDGameState state;
+    uint64_t hash;
+    std::size_t record;
+    int g;
+    int h;
+    int priority;
+};
+
+struct Goal {
+    NodeRef parent;
+    Action action;
+    int g;
+};
+
+struct Worker {
+    Worker() : inbox(kQueueCapacity) {}
+    Worker(const Worker &) = delete;
+    Worker(Worker &&) = delete;
+    auto operator=(const Worker &) -> Worker & = delete;
+    auto operator=(Worker &&) -> Worker & = delete;
+    ~Worker() {
+        Message *message = nullptr;
+        while (inbox.try_pop(message)) {
+            delete message;    // NOLINT(*-owning-memory)
+        }
+    }
+
+    MPMCQueue<Message *> inbox;                                     // Owning pointers sent by other workers
+    std::vector<std::vector<std::unique_ptr<Message>>> overflow;    // Messages waiting for room, by destination
+    std::vector<OpenNode> open;                                     // Binary heap, best node at the front
+    std::unordered_map<uint64_t, Label> closed;
+    std::vector<NodeRecord> records;
+    std::vector<Goal> goals;
+    std::size_t nodes_expanded = 0;
+    std::size_t nodes_generated = 0;
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+    std::atomic<bool> idle{false};                                  // Set while the worker may block on idle_cv
+    std::atomic<std::size_t> wake_epoch{0};                         // Bumped under idle_mutex to wake the worker
+};
+
+// Heap order, true if a should be expanded after b
+auto worse(const OpenNode &a, const OpenNode &b) noexcept -> bool {
+    return a.priority != b.priority ? a.priority > b.priority : a.h > b.h;
+}
+
+class HDASearch {
+public:
+    HDASearch(const HDAOptions &options, std::size_t num_workers, std::size_t state_bytes)
+        : options(options), workers(num_workers), state_bytes(state_bytes) {
+        for (auto &worker : workers) {
+            worker.overflow.resize(num_workers);
+        }
+    }
+
+    void AddRoot(const RNDGameState &state) {
+        const uint64_t hash = state.get_hash();
+        Worker &worker = workers[hash % workers.size()];
+        worker.records.push_back({{kNoWorker, 0}, Action::kNoop});
+        worker.closed.emplace(hash, Label{0, state.get_steps_remaining()});
+        const int h = Heuristic(state);
+        worker.open.push_back({state, hash, 0, 0, h, Priority(0, h)});
+        pending = 1;
+        num_closed = 1;
+    }
+
+    void Run(std::size_t idx) {
+        Worker &worker = workers[idx];
+        std::vector<Action> actions;
+        std::size_t local_expansions = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            Message *raw = nullptr;
+            while (worker.inbox.try_pop(raw)) {
+                Receive(idx, std::unique_ptr<Message>(raw));
+            }
+            const bool has_overflow = FlushOverflow(worker);
+            if (worker.open.empty()) {
+                if (pending.load() == 0) {
+                    break;
+                }
+                // Messages held back for a full inbox are only sent by this worker, so it must not block on them
+                if (has_overflow) {
+                    std::this_thread::yield();
+                } else {
+                    WaitForWork(idx);
+                }
+                continue;
+            }
+            std::pop_heap(worker.open.begin(), worker.open.end(), worse);
+            OpenNode node = std::move(worker.open.back());
+            worker.open.pop_back();
+            if (!IsStale(worker, node)) {
+                Expand(idx, node, actions);
+                if (++local_expansions % kLimitCheckInterval == 0) {
+                    CheckMemory();
+                }
+            }
+            Done();
+        }
+    }
+
+    void Finish(SearchResult &result) const {
+        const Goal *best = nullptr;
+        for (const auto &worker : workers) {
+            result.nodes_expanded += worker.nodes_expanded;
+            result.nodes_generated += worker.nodes_generated;
+            for (const auto &goal : worker.goals) {
+                if (best == nullptr || goal.g < best->g) {
+                    best = &goal;
+                }
+            }
+        }
+        result.hit_limit = hit_limit.load();
+        if (best == nullptr) {
+            return;
+        }
+        result.solved = true;
+        result.solution.push_back(best->action);
+        NodeRef ref = best->parent;
+        while (true) {
+            const NodeRecord &record = workers[ref.worker].records[ref.index];
+            if (record.parent.worker == kNoWorker) {
+                break;
+            }
+            result.solution.push_back(record.action);
+            ref = record.parent;
+        }
+        std::reverse(result.solution.begin(), result.solution.end());
+    }
+
+private:
+    [[nodiscard]] auto Heuristic(const RNDGameState &state) const -> int {
+        return options.heuristic ? options.heuristic(state) : 0;
+    }
+
+    [[nodiscard]] auto Priority(int g, int h) const noexcept -> int {
+        return options.greedy ? h : g + options.heuristic_weight * h;
+    }
+
+    // A node is stale if a node for the same state with no more cost and no fewer steps remaining was accepted since
+    [[nodiscard]] auto IsStale(const Worker &worker, const OpenNode &node) const -> bool {
+        const Label &label = worker.closed.at(node.hash);
+        const int steps = node.state.get_steps_remaining();
+        const bool dominated = (label.g < node.g && label.steps_remaining >= steps) ||
+                               (label.g <= node.g && label.steps_remaining > steps);
+        return dominated || (!options.greedy && node.g + node.h >= incumbent.load(std::memory_order_relaxed));
+    }
+
+    // Accept or drop a child sent to this worker
+    void Receive(std::size_t idx, std::unique_ptr<Message> message) {
+        Worker &worker = workers[idx];
+        const int steps = message->state.get_steps_remaining();
+        const auto [it, inserted] = worker.closed.try_emplace(message->hash, Label{message->g, steps});
+        if (inserted) {
+            ++num_closed;
+        } else {
+            Label &label = it->second;
+            if (label.g <= message->g && label.steps_remaining >= steps) {
+                Done();
+                return;
+            }
+            // Keep a single label per state, any accepted label is safe to prune against
+            if (message->g < label.g || (message->g == label.g && steps > label.steps_remaining)) {
+                label = {message->g, steps};
+            }
+        }
+        const int h = Heuristic(message->state);
+        if (!options.greedy && message->g + h >= incumbent.load(std::memory_order_relaxed)) {
+            Done();
+            return;
+        }
+        worker.records.push_back({message->parent, message->action});
+        const std::size_t record = worker.records.size() - 1;
+        worker.open.push_back(
+            {std::move(message->state), message->hash, record, message->g, h, Priority(message->g, h)});
+        std::push_heap(worker.open.begin(), worker.open.end(), worse);
+    }
+
+    void Expand(std::size_t idx, const OpenNode &node, std::vector<Action> &actions) {
+        Worker &worker = workers[idx];
+        if (options.max_expansions > 0 && ++num_expanded > options.max_expansions) {
+            hit_limit = true;
+            Stop();
+            return;
+        }
+        ++worker.nodes_expanded;
+        const NodeRef parent{idx, node.record};
+        node.state.legal_actions(actions, options.prune_actions);
+        for (const auto action : actions) {
+            if (options.prune_actions && node.state.is_action_fatal(action)) {
+                continue;
+            }
+            auto message = std::make_unique<Message>(Message{node.state, 0, parent, action, 0});
+            RNDGameState &child = message->state;
+            child.apply_action(action);
+            ++worker.nodes_generated;
+            message->g = node.g + (options.cost ? options.cost(node.state, action, child) : 1);
+            if (child.is_solution()) {
+                worker.goals.push_back({parent, action, message->g});
+                int best = incumbent.load();
+                while (message->g < best && !incumbent.compare_exchange_weak(best, message->g)) {
+                }
+                if (options.greedy) {
+                    Stop();
+                }
+                continue;
+            }
+            // Covers agent deaths and running out of steps, neither can lead to a solution
+            if (child.is_terminal()) {
+                continue;
+            }
+            message->hash = child.get_hash();
+            const std::size_t dest = message->hash % workers.size();
+            ++pending;
+            if (dest == idx) {
+                Receive(idx, std::move(message));
+            } else if (worker.overflow[dest].empty() && workers[dest].inbox.try_push(message.get())) {
+                message.release();    // NOLINT(*-unused-return-value)
+                Notify(dest);
+            } else {
+                worker.overflow[dest].push_back(std::move(message));
+            }
+        }
+    }
+
+    // Send held back messages, returns true if any are still waiting for room
+    auto FlushOverflow(Worker &worker) -> bool {
+        bool has_overflow = false;
+        for (std::size_t dest = 0; dest < workers.size(); ++dest) {
+            auto &messages = worker.overflow[dest];
+            const std::size_t num_waiting = messages.size();
+            while (!messages.empty() && workers[dest].inbox.try_push(messages.back().get())) {
+                messages.back().release();    // NOLINT(*-unused-return-value)
+                messages.pop_back();
+            }
+            if (messages.size() != num_waiting) {
+                Notify(dest);
+            }
+            has_overflow = has_overflow || !messages.empty();
+        }
+        return has_overflow;
+    }
+
+    // Block until a message is pushed to the inbox or the search ends. The worker announces itself idle before its last
+    // look at the inbox and senders check the flag after their push, so with both fenced one side always sees the
+    // other and no wake up is lost. Senders to a busy worker only pay for the flag load.
+    void WaitForWork(std::size_t idx) {
+        Worker &worker = workers[idx];
+        worker.idle.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::size_t epoch = worker.wake_epoch.load();
+        Message *raw = nullptr;
+        if (worker.inbox.try_pop(raw)) {
+            worker.idle.store(false);
+            Receive(idx, std::unique_ptr<Message>(raw));
+            return;
+        }
+        std::unique_lock<std::mutex> lock(worker.idle_mutex);
+        worker.idle_cv.wait(lock, [&]() {
+            return worker.wake_epoch.load() != epoch || pending.load() == 0 || stop.load(std::memory_order_relaxed);
+        });
+        worker.idle.store(false);
+    }
+
+    // Wake the worker if it is waiting for messages
+    void Notify(std::size_t dest) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Worker &worker = workers[dest];
+        if (worker.idle.load()) {
+            {
+                const std::lock_guard<std::mutex> lock(worker.idle_mutex);
+                ++worker.wake_epoch;
+            }
+            worker.idle_cv.notify_one();
+        }
+    }
+
+    void NotifyAll() {
+        for (std::size_t dest = 0; dest < workers.size(); ++dest) {
+            Notify(dest);
+        }
+    }
+
+    // A queued node was expanded or dropped, waiting workers exit once the last one is
+    void Done() {
+        if (--pending == 0) {
+            NotifyAll();
+        }
+    }
+
+    void Stop() {
+        stop = true;
+        NotifyAll();
+    }
+
+    void CheckMemory() {
+        if (options.max_memory_mb == 0) {
+            return;
+        }
+        const std::size_t memory_bytes = num_closed.load() * kClosedEntryBytes + pending.load() * state_bytes;
+        if (memory_bytes > options.max_memory_mb * kBytesPerMB) {
+            hit_limit = true;
+            Stop();
+        }
+    }
+
+    const HDAOptions &options;
+    std::vector<Worker> workers;
+    std::size_t state_bytes;
+    std::atomic<std::size_t> pending{0};    // Nodes queued, in flight, or open, the search is done when it reaches 0
+    std::atomic<std::size_t> num_closed{0};
+    std::atomic<std::size_t> num_expanded{0};
+    std::atomic<int> incumbent{kNoIncumbent};    // Cost of the best solution found so far
+    std::atomic<bool> stop{false};
+    std::atomic<bool> hit_limit{false};
+};
+}    // namespace
+
+auto hda_solve(const RNDGameState &state, const HDAOptions &options) -> SearchResult {
+    const auto start_time = std::chrono::steady_clock::now();
+    SearchResult result;
+    if (state.is_solution()) {
+        result.solved = true;
+        return result;
+    }
+    if (state.is_terminal()) {
+        return result;
+    }
+
+    const std::unique_ptr<ThreadPool> pool =
+        (options.num_threads == 1) ? nullptr : std::make_unique<ThreadPool>(options.num_threads);
+    const std::size_t num_workers = pool ? pool->num_threads() : 1;
+    HDASearch search(options, num_workers, state.memory_bytes());
+    search.AddRoot(state);
+    if (pool) {
+        pool->run([&search](std::size_t idx) { search.Run(idx); });
+    } else {
+        search.Run(0);
+    }
+    search.Finish(result);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
+}    // namespace stonesngems
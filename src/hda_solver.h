@@ -0,0 +1,45 @@
+#ifndef STONESNGEMS_HDA_SOLVER_H_
+#define STONESNGEMS_HDA_SOLVER_H_
+
+#include <cstddef>
+#include <functional>
+
+#include "definitions.h"
+#include "search_result.h"
+#include "stonesngems_base.h"
+
+namespace stonesngems {
+
+// Estimated cost from a state to a solution, should be admissible for optimal search
+using HeuristicFunction = std::function<int(const RNDGameState &)>;
+
+// Cost of the edge from parent to child through the given action, must be non-negative
+using CostFunction = std::function<int(const RNDGameState &parent, Action action, const RNDGameState &child)>;
+
+struct HDAOptions {
+    std::size_t num_threads = 1;       // Number of worker threads, 0 uses the hardware concurrency
+    HeuristicFunction heuristic;       // Heuristic callback, empty for 0 everywhere
+    CostFunction cost;                 // Edge cost callback, empty for unit cost
+    int heuristic_weight = 1;          // Weight on the heuristic, f = g + w * h
+    bool greedy = false;               // Order nodes by h alone and stop at the first solution found
+    std::size_t max_expansions = 0;    // Maximum number of nodes to expand over all threads, 0 for no limit
+    std::size_t max_memory_mb = 0;     // Estimated memory limit for the open and closed lists, 0 for no limit
+    bool prune_actions = true;         // Skip actions equivalent to kNoop and actions which are certain to be fatal
+};
+
+/**
+ * Search for a solution with hash distributed A* (HDA*), or greedy best-first search.
+ * Every worker owns an open list and a closed list for the states whose get_hash() maps to it. Generated children are
+ * sent to their owner through lock-free queues, and each worker expands its own best node independently.
+ * Levels with a step limit are handled by only treating a duplicate as redundant if it was reached with no more cost
+ * and no fewer steps remaining, so a cheaper path which times out never hides a slower path which does not.
+ * With an admissible heuristic, a weight of 1 and greedy disabled, the returned solution has the lowest cost.
+ * @param state The root state
+ * @param options Search options
+ * @return The search result, with the solution if found
+ */
+[[nodiscard]] auto hda_solve(const RNDGameState &state, const HDAOptions &options = {}) -> SearchResult;
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_HDA_SOLVER_H_
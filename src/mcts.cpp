@@ -0,0 +1,459 @@
+#include "mcts.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "definitions.h"
+#include "rollout.h"
+#include "search_result.h"
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+namespace {
+constexpr uint32_t kNoNode = std::numeric_limits<uint32_t>::max();
+
+enum NodeStatus : uint8_t {
+    kUnexpanded = 0,
+    kExpanding = 1,    // Claimed by a thread which is computing its state and evaluation
+    kExpanded = 2,
+    kTerminal = 3,
+};
+
+void atomic_add(std::atomic<double> &target, double value) noexcept {
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+    }
+}
+}    // namespace
+
+struct MCTS::Node {
+    std::atomic<int> visits{0};
+    std::atomic<int> virtual_visits{0};
+    std::atomic<double> value_sum{0};    // Sum of the returns from the parent through this node
+    std::atomic<uint8_t> status{kUnexpanded};
+    // Written by the expanding thread before status is released
+    uint32_t parent = kNoNode;
+    uint32_t first_child = kNoNode;
+    uint32_t depth = 0;
+    float prior = 0;
+    float reward = 0;    // Reward received on the step into this node
+    float terminal_value = 0;
+    uint8_t action = 0;    // Index in ALL_ACTIONS of the edge from the parent
+    bool legal = false;
+
+    void Init(uint32_t parent_idx, uint8_t action_idx, uint32_t node_depth, float node_prior, bool is_legal) noexcept {
+        visits.store(0, std::memory_order_relaxed);
+        virtual_visits.store(0, std::memory_order_relaxed);
+        value_sum.store(0, std::memory_order_relaxed);
+        status.store(kUnexpanded, std::memory_order_relaxed);
+        parent = parent_idx;
+        first_child = kNoNode;
+        depth = node_depth;
+        prior = node_prior;
+        reward = 0;
+        terminal_value = 0;
+        action = action_idx;
+        legal = is_legal;
+    }
+};
+
+struct MCTS::Worker {
+    std::unique_ptr<RNDGameState> scratch;
+    std::vector<uint32_t> path;
+    std::vector<Action> replay;    // Actions from the closest stored ancestor to the current node
+    std::vector<Action> actions;
+    RolloutEngine rollout{1};
+    RolloutOptions rollout_options;
+    Evaluation evaluation;
+};
+
+MCTS::MCTS(MCTSOptions options)
+    : options(std::move(options)),
+      pool(this->options.num_threads == 1 ? nullptr : std::make_unique<ThreadPool>(this->options.num_threads)),
+      workers(pool ? pool->num_threads() : 1),
+      solution_node(kNoNode) {
+    if (this->options.state_interval == 0) {
+        throw std::invalid_argument("state_interval must be positive");
+    }
+    if (this->options.max_nodes < 1 + kNumActions || this->options.max_nodes >= kNoNode) {
+        throw std::invalid_argument("max_nodes must hold the root and its children, and fit a 32 bit index");
+    }
+    nodes = std::make_unique<Node[]>(this->options.max_nodes);    // NOLINT(*-avoid-c-arrays)
+    states.resize(this->options.max_nodes);
+}
+
+MCTS::~MCTS() = default;
+
+void MCTS::set_root(const RNDGameState &state) {
+    for (std::size_t i = 0; i < num_nodes(); ++i) {
+        states[i].reset();
+    }
+    root = 0;
+    nodes[root].Init(kNoNode, 0, 0, 1, true);
+    states[root] = std::make_unique<RNDGameState>(state);
+    num_allocated = 1;
+    solution_node = kNoNode;
+    min_value = std::numeric_limits<double>::infinity();
+    max_value = -std::numeric_limits<double>::infinity();
+}
+
+void MCTS::search() {
+    if (!states[root]) {
+        throw std::logic_error("MCTS root has not been set");
+    }
+    // Continue the seeds after the range of the last call, so every call plays out fresh rollout seeds
+    next_simulation = simulation_end.load();
+    simulation_end = next_simulation + options.num_simulations;
+    const auto job = [this](std::size_t worker_idx) {
+        Worker &worker = workers[worker_idx];
+        if (!worker.scratch) {
+            worker.scratch = std::make_unique<RNDGameState>(*states[root]);
+        }
+        while (true) {
+            const std::size_t simulation = next_simulation.fetch_add(1);
+            if (simulation >= simulation_end.load() ||
+                (options.stop_on_solution && solution_node.load() != kNoNode)) {
+                break;
+            }
+            worker.rollout_options = options.rollout;
+            worker.rollout_options.seed = options.rollout.seed + simulation;
+            Simulate(worker);
+            simulations_run.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+    if (pool) {
+        pool->run(job);
+    } else {
+        job(0);
+    }
+}
+
+void MCTS::advance(Action action) {
+    if (!states[root]) {
+        throw std::logic_error("MCTS root has not been set");
+    }
+    RNDGameState next = *states[root];
+    next.apply_action(action);
+    const Node &node = nodes[root];
+    // Start a new tree once half of the arena is used, most of it belongs to siblings which are no longer reachable
+    if (node.status.load() != kExpanded || num_nodes() > options.max_nodes / 2) {
+        set_root(next);
+        return;
+    }
+    const uint32_t child = Child(root, static_cast<std::size_t>(action));
+    if (!states[child]) {
+        states[child] = std::make_unique<RNDGameState>(std::move(next));
+    }
+    root = child;
+    uint32_t idx = solution_node.load();
+    while (idx != kNoNode && idx != root) {
+        idx = nodes[idx].parent;
+    }
+    if (idx == kNoNode) {
+        solution_node = kNoNode;
+    }
+}
+
+auto MCTS::root_state() const -> const RNDGameState & {
+    if (!states[root]) {
+        throw std::logic_error("MCTS root has not been set");
+    }
+    return *states[root];
+}
+
+auto MCTS::root_policy() const -> std::array<float, kNumActions> {
+    std::array<float, kNumActions> policy{};
+    const Node &node = nodes[root];
+    if (node.status.load() != kExpanded) {
+        return policy;
+    }
+    float total = 0;
+    for (std::size_t a = 0; a < kNumActions; ++a) {
+        policy[a] = static_cast<float>(nodes[Child(root, a)].visits.load());    // NOLINT(*-constant-array-index)
+        total += policy[a];                                                      // NOLINT(*-constant-array-index)
+    }
+    if (total > 0) {
+        for (auto &p : policy) {
+            p /= total;
+        }
+    }
+    return policy;
+}
+
+auto MCTS::root_value() const -> float {
+    const Node &node = nodes[root];
+    const int visits = node.visits.load();
+    return visits > 0 ? static_cast<float>(node.value_sum.load() / visits) : 0;
+}
+
+auto MCTS::best_action() const -> Action {
+    const std::array<float, kNumActions> policy = root_policy();
+    const auto best = static_cast<std::size_t>(std::max_element(policy.begin(), policy.end()) - policy.begin());
+    return policy[best] > 0 ? RNDGameState::ALL_ACTIONS[best] : Action::kNoop;    // NOLINT(*-constant-array-index)
+}
+
+auto MCTS::solution() const -> std::vector<Action> {
+    std::vector<Action> actions;
+    uint32_t idx = solution_node.load();
+    while (idx != kNoNode && idx != root) {
+        actions.push_back(RNDGameState::ALL_ACTIONS[nodes[idx].action]);
+        idx = nodes[idx].parent;
+    }
+    if (idx == kNoNode) {
+        return {};
+    }
+    std::reverse(actions.begin(), actions.end());
+    return actions;
+}
+
+auto MCTS::num_simulations() const noexcept -> std::size_t {
+    return simulations_run.load(std::memory_order_relaxed);
+}
+
+auto MCTS::num_nodes() const noexcept -> std::size_t {
+    return std::min(num_allocated.load(), options.max_nodes);
+}
+
+auto MCTS::Child(uint32_t idx, std::size_t action) const noexcept -> uint32_t {
+    return nodes[idx].first_child + static_cast<uint32_t>(action);
+}
+
+// PUCT, with Q normalised by the bounds of the returns seen so far and virtual visits counted as the worst return
+auto MCTS::SelectChild(uint32_t idx) const noexcept -> uint32_t {
+    const Node &node = nodes[idx];
+    const int parent_visits = node.visits.load(std::memory_order_relaxed) +
+                              node.virtual_visits.load(std::memory_order_relaxed);
+    const double exploration = options.c_puct * std::sqrt(static_cast<double>(std::max(parent_visits, 1)));
+    const double low = min_value.load(std::memory_order_relaxed);
+    const double high = max_value.load(std::memory_order_relaxed);
+    const bool bounded = low <= high;
+    const double range = high - low;
+    double best_score = std::numeric_limits<double>::lowest();
+    uint32_t best = kNoNode;
+    for (std::size_t a = 0; a < kNumActions; ++a) {
+        const uint32_t child_idx = Child(idx, a);
+        const Node &child = nodes[child_idx];
+        if (!child.legal) {
+            continue;
+        }
+        const int visits = child.visits.load(std::memory_order_relaxed);
+        const int virtual_visits = child.virtual_visits.load(std::memory_order_relaxed);
+        const int total = visits + virtual_visits;
+        double q = 0;
+        if (total > 0 && bounded && range > 0) {
+            const double value_sum = child.value_sum.load(std::memory_order_relaxed) + virtual_visits * low;
+            q = (value_sum / total - low) / range;
+        }
+        const double score = q + exploration * child.prior / (1 + total);
+        if (score > best_score) {
+            best_score = score;
+            best = child_idx;
+        }
+    }
+    return best;
+}
+
+void MCTS::Simulate(Worker &worker) {
+    while (true) {
+        worker.path.clear();
+        worker.replay.clear();
+        uint32_t stored = root;
+        uint32_t idx = root;
+        float value = 0;
+        bool busy = false;
+        while (true) {
+            Node &node = nodes[idx];
+            worker.path.push_back(idx);
+            node.virtual_visits.fetch_add(options.virtual_loss, std::memory_order_relaxed);
+            uint8_t status = node.status.load(std::memory_order_acquire);
+            if (status == kUnexpanded &&
+                node.status.compare_exchange_strong(status, kExpanding, std::memory_order_acq_rel)) {
+                RNDGameState &state = *worker.scratch;
+                state = *states[stored];
+                for (const auto action : worker.replay) {
+                    state.apply_action(action);
+                }
+                Expand(idx, worker, value);
+                break;
+            }
+            if (status == kTerminal) {
+                value = node.terminal_value;
+                break;
+            }
+            if (status != kExpanded) {
+                busy = true;
+                break;
+            }
+            if (states[idx]) {
+                stored = idx;
+                worker.replay.clear();
+            }
+            idx = SelectChild(idx);
+            worker.replay.push_back(RNDGameState::ALL_ACTIONS[nodes[idx].action]);
+        }
+        if (!busy) {
+            Backup(worker.path, value);
+            return;
+        }
+        // Another thread is expanding a node on the path, back off and select again
+        UndoVirtualLoss(worker.path);
+        std::this_thread::yield();
+    }
+}
+
+void MCTS::Expand(uint32_t idx, Worker &worker, float &value) {
+    Node &node = nodes[idx];
+    const RNDGameState &state = *worker.scratch;
+    node.reward = static_cast<float>(state.get_current_reward());
+    const bool solved = state.is_solution();
+    if (solved || state.is_terminal()) {
+        node.terminal_value = solved ? options.solution_value : options.death_value;
+        value = node.terminal_value;
+        if (solved) {
+            uint32_t expected = kNoNode;
+            solution_node.compare_exchange_strong(expected, idx);
+        }
+        node.status.store(kTerminal, std::memory_order_release);
+        return;
+    }
+
+    Evaluation &evaluation = worker.evaluation;
+    if (options.evaluate) {
+        options.evaluate(state, evaluation);
+    } else {
+        const RolloutStats stats = worker.rollout.run(state, worker.rollout_options);
+        const auto num_failed = static_cast<double>(stats.num_terminal - stats.num_solved);
+        evaluation.priors.fill(1);
+        evaluation.value =
+            static_cast<float>(stats.mean_return() + options.solution_value * stats.solve_rate() +
+                               options.death_value * num_failed / static_cast<double>(std::max<std::size_t>(
+                                                                      stats.num_playouts, 1)));
+    }
+    value = evaluation.value;
+
+    // Without room for the children the node stays a leaf, and is evaluated again on every visit
+    const std::size_t first_child = num_allocated.fetch_add(kNumActions);
+    if (first_child + kNumActions > options.max_nodes) {
+        node.status.store(kUnexpanded, std::memory_order_release);
+        return;
+    }
+
+    // Pruned actions get no child, unless every remaining action is fatal
+    std::array<bool, kNumActions> legal{};
+    std::array<bool, kNumActions> safe{};
+    bool any_safe = false;
+    state.legal_actions(worker.actions, options.prune_actions);
+    for (const auto action : worker.actions) {
+        const auto a = static_cast<std::size_t>(action);
+        legal[a] = true;                                                         // NOLINT(*-constant-array-index)
+        safe[a] = !options.prune_actions || !state.is_action_fatal(action);    // NOLINT(*-constant-array-index)
+        any_safe = any_safe || safe[a];                                          // NOLINT(*-constant-array-index)
+    }
+    legal = any_safe ? safe : legal;
+    // NOLINTBEGIN(*-constant-array-index)
+    float prior_sum = 0;
+    std::size_t num_legal = 0;
+    for (std::size_t a = 0; a < kNumActions; ++a) {
+        if (legal[a]) {
+            prior_sum += std::max(evaluation.priors[a], 0.0F);
+            ++num_legal;
+        }
+    }
+    for (std::size_t a = 0; a < kNumActions; ++a) {
+        float prior = 0;
+        if (legal[a]) {
+            prior = prior_sum > 0 ? std::max(evaluation.priors[a], 0.0F) / prior_sum
+                                  : 1.0F / static_cast<float>(num_legal);
+        }
+        nodes[first_child + a].Init(idx, static_cast<uint8_t>(a), node.depth + 1, prior, legal[a]);
+    }
+    // NOLINTEND(*-constant-array-index)
+    if (node.depth % options.state_interval == 0 && !states[idx]) {
+        states[idx] = std::make_unique<RNDGameState>(state);
+    }
+    node.first_child = static_cast<uint32_t>(first_child);
+    node.status.store(kExpanded, std::memory_order_release);
+}
+
+void MCTS::Backup(const std::vector<uint32_t> &path, float value) noexcept {
+    // The return of a child includes the reward on the step into it, the root only averages its children
+    double ret = value;
+    for (std::size_t i = path.size(); i-- > 0;) {
+        Node &node = nodes[path[i]];
+        if (i > 0) {
+            ret = node.reward + options.discount * ret;
+            UpdateBounds(ret);
+        }
+        atomic_add(node.value_sum, ret);
+        node.visits.fetch_add(1, std::memory_order_relaxed);
+        node.virtual_visits.fetch_sub(options.virtual_loss, std::memory_order_relaxed);
+    }
+}
+
+void MCTS::UndoVirtualLoss(const std::vector<uint32_t> &path) noexcept {
+    for (const auto idx : path) {
+        nodes[idx].virtual_visits.fetch_sub(options.virtual_loss, std::memory_order_relaxed);
+    }
+}
+
+void MCTS::UpdateBounds(double value) noexcept {
+    // The bounds start empty (min +inf, max -inf), so the first return seeds both through the same CAS loops and racing
+    // threads can only widen them
+    double current = min_value.load(std::memory_order_relaxed);
+    while (value < current && !min_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+    current = max_value.load(std::memory_order_relaxed);
+    while (value > current && !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+auto mcts_solve(const RNDGameState &state, const MCTSOptions &options, std::size_t max_steps) -> SearchResult {
+    const auto start_time = std::chrono::steady_clock::now();
+    SearchResult result;
+    MCTS tree(options);
+    tree.set_root(state);
+    while (!tree.root_state().is_solution() && !tree.root_state().is_terminal()) {
+        if (result.solution.size() >= max_steps) {
+            result.hit_limit = true;
+            break;
+        }
+        const std::size_t nodes_before = tree.num_nodes();
+        const std::size_t simulations_before = tree.num_simulations();
+        tree.search();
+        result.nodes_expanded += tree.num_simulations() - simulations_before;
+        result.nodes_generated += tree.num_nodes() - std::min(nodes_before, tree.num_nodes());
+        const std::vector<Action> path = tree.solution();
+        if (!path.empty()) {
+            result.solution.insert(result.solution.end(), path.begin(), path.end());
+            break;
+        }
+        const Action action = tree.best_action();
+        result.solution.push_back(action);
+        tree.advance(action);
+    }
+    RNDGameState replay = state;
+    for (const auto action : result.solution) {
+        replay.apply_action(action);
+    }
+    result.solved = replay.is_solution();
+    if (!result.solved) {
+        result.solution.clear();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
+}    // namespace stonesngems
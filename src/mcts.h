@@ -0,0 +1,169 @@
+#ifndef STONESNGEMS_MCTS_H_
+#define STONESNGEMS_MCTS_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "definitions.h"
+#include "rollout.h"
+#include "search_result.h"
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+// Prior over ALL_ACTIONS and value estimate of a leaf state
+struct Evaluation {
+    std::array<float, kNumActions> priors{};
+    float value = 0;
+};
+
+// Evaluate a leaf, called concurrently from every search thread
+using EvaluateFunction = std::function<void(const RNDGameState &state, Evaluation &evaluation)>;
+
+struct MCTSOptions {
+    std::size_t num_threads = 1;          // Number of worker threads, 0 uses the hardware concurrency
+    std::size_t num_simulations = 800;    // Simulations per call to search()
+    std::size_t max_nodes = 1 << 20;      // Capacity of the node arena
+    std::size_t state_interval = 4;       // Store states at depths which are a multiple of this, replay the rest
+    float c_puct = 1.25F;                 // Weight of the prior in the PUCT selection rule
+    int virtual_loss = 3;                 // Virtual visits added to each node on the path of a running simulation
+    float discount = 1;                   // Discount applied to the reward of each later step
+    float solution_value = 1;             // Value of a solved state
+    float death_value = -1;               // Value of any other terminal state
+    bool prune_actions = true;            // Skip actions equivalent to kNoop and actions which are certain to be fatal
+    bool stop_on_solution = true;         // End search() as soon as a simulation reaches a solution
+    EvaluateFunction evaluate;            // Leaf evaluation, empty for uniform priors and a random rollout value
+    // Playouts of the default evaluation, a single safe random playout
+    RolloutOptions rollout{1, 100, 0, RolloutPolicy::kSafe, 1};
+};
+
+// Monte Carlo tree search over RNDGameState with PUCT selection.
+// Nodes live in a fixed arena, and the children of a node are the kNumActions consecutive nodes for ALL_ACTIONS.
+// States are only kept for nodes at depths which are a multiple of state_interval, other states are recomputed by
+// replaying the actions from the closest stored ancestor. Threads search the same tree, and virtual loss steers
+// concurrent simulations away from each other.
+class MCTS {
+public:
+    /**
+     * Create the search with an empty tree.
+     * @param options Search options
+     * @throws std::invalid_argument if max_nodes is too small for the root and its children, max_nodes exceeds the
+     * node index range, or state_interval is 0
+     */
+    explicit MCTS(MCTSOptions options = {});
+
+    MCTS(const MCTS &) = delete;
+    MCTS(MCTS &&) = delete;
+    auto operator=(const MCTS &) -> MCTS & = delete;
+    auto operator=(MCTS &&) -> MCTS & = delete;
+    ~MCTS();
+
+    /**
+     * Discard the tree and start from the given state.
+     * @param state The new root state
+     */
+    void set_root(const RNDGameState &state);
+
+    /**
+     * Run num_simulations simulations from the root.
+     * @throws std::logic_error if no root has been set
+     */
+    void search();
+
+    /**
+     * Move the root to the child for the given action, keeping its subtree.
+     * @param action The action taken from the root
+     * @throws std::logic_error if no root has been set
+     */
+    void advance(Action action);
+
+    /**
+     * Get the root state.
+     * @return The root state
+     */
+    [[nodiscard]] auto root_state() const -> const RNDGameState &;
+
+    /**
+     * Get the visit distribution over ALL_ACTIONS at the root, the policy target for AlphaZero style training.
+     * @return Visit count of each child divided by the total, all 0 if no child was visited
+     */
+    [[nodiscard]] auto root_policy() const -> std::array<float, kNumActions>;
+
+    /**
+     * Get the mean value of the simulations through the root.
+     * @return Mean backed up return, 0 if the root was not visited
+     */
+    [[nodiscard]] auto root_value() const -> float;
+
+    /**
+     * Get the most visited action at the root.
+     * @return Action with the most visits, kNoop if no child was visited
+     */
+    [[nodiscard]] auto best_action() const -> Action;
+
+    /**
+     * Get the actions from the root to a solution reached by a simulation.
+     * @return The actions, empty if no simulation has reached a solution in the subtree of the root
+     */
+    [[nodiscard]] auto solution() const -> std::vector<Action>;
+
+    /**
+     * Get the number of simulations completed by all calls to search(), fewer than num_simulations per call when
+     * stop_on_solution ends a search early.
+     * @return Number of simulations
+     */
+    [[nodiscard]] auto num_simulations() const noexcept -> std::size_t;
+
+    /**
+     * Get the number of nodes allocated in the arena.
+     * @return Number of nodes
+     */
+    [[nodiscard]] auto num_nodes() const noexcept -> std::size_t;
+
+private:
+    struct Node;
+    struct Worker;
+
+    [[nodiscard]] auto Child(uint32_t idx, std::size_t action) const noexcept -> uint32_t;
+    [[nodiscard]] auto SelectChild(uint32_t idx) const noexcept -> uint32_t;
+    void Simulate(Worker &worker);
+    void Expand(uint32_t idx, Worker &worker, float &value);
+    void Backup(const std::vector<uint32_t> &path, float value) noexcept;
+    void UndoVirtualLoss(const std::vector<uint32_t> &path) noexcept;
+    void UpdateBounds(double value) noexcept;
+
+    MCTSOptions options;
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<Worker> workers;
+    std::unique_ptr<Node[]> nodes;    // NOLINT(*-avoid-c-arrays)
+    std::vector<std::unique_ptr<RNDGameState>> states;    // Stored states by node index, null if recomputed
+    std::atomic<std::size_t> num_allocated{0};
+    std::atomic<std::size_t> next_simulation{0};
+    std::atomic<std::size_t> simulation_end{0};          // End of the rollout seed range of the last search()
+    std::atomic<uint32_t> solution_node;
+    std::atomic<double> min_value{0};    // Bounds of the backed up returns to normalise Q, empty while min > max
+    std::atomic<double> max_value{0};
+    std::atomic<std::size_t> simulations_run{0};    // Simulations completed by all calls to search()
+    uint32_t root = 0;
+};
+
+/**
+ * Solve a level by repeatedly searching from the current state and taking the most visited action, returning as soon
+ * as a simulation reaches a solution.
+ * @param state The initial state
+ * @param options Search options
+ * @param max_steps Maximum number of actions to take
+ * @return The search result, with the solution if found
+ */
+[[nodiscard]] auto mcts_solve(const RNDGameState &state, const MCTSOptions &options, std::size_t max_steps)
+    -> SearchResult;
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_MCTS_H_
@@ -0,0 +1,103 @@
+#ifndef STONESNGEMS_MPMC_QUEUE_H_
+#define STONESNGEMS_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace stonesngems {
+
+// Bounded lock-free multi-producer multi-consumer queue (Vyukov), each cell carries a sequence number which tells
+// producers and consumers whose turn it is.
+template <typename T>
+class MPMCQueue {
+public:
+    /**
+     * Create the queue.
+     * @param capacity Minimum number of elements the queue can hold, rounded up to a power of two
+     */
+    explicit MPMCQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        cells = std::make_unique<Cell[]>(size);    // NOLINT(*-avoid-c-arrays)
+        for (std::size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue &) = delete;
+    MPMCQueue(MPMCQueue &&) = delete;
+    auto operator=(const MPMCQueue &) -> MPMCQueue & = delete;
+    auto operator=(MPMCQueue &&) -> MPMCQueue & = delete;
+    ~MPMCQueue() = default;
+
+    /**
+     * Push an element if there is room.
+     * @param value The element to push
+     * @return True if the element was pushed, false if the queue is full
+     */
+    auto try_push(const T &value) noexcept -> bool {
+        std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell &cell = cells[pos & mask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Pop the oldest element if there is one.
+     * @param value Set to the popped element
+     * @return True if an element was popped, false if the queue is empty
+     */
+    auto try_pop(T &value) noexcept -> bool {
+        std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell &cell = cells[pos & mask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.data;
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;    // NOLINT(*-avoid-c-arrays)
+    std::size_t mask = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueue_pos{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeue_pos{0};
+};
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_MPMC_QUEUE_H_
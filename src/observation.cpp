@@ -0,0 +1,80 @@
+#include "observation.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+namespace {
+// Run func(n) over each state in the batch, optionally split across the pool
+template <typename F>
+void for_each_state(std::size_t num_states, ThreadPool *pool, F &&func) {
+    if (pool == nullptr) {
+        for (std::size_t n = 0; n < num_states; ++n) {
+            func(n);
+        }
+        return;
+    }
+    pool->parallel_for(num_states, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t n = begin; n < end; ++n) {
+            func(n);
+        }
+    });
+}
+
+[[nodiscard]] auto observation_size(const RNDGameState &state) noexcept -> std::size_t {
+    const auto shape = state.observation_shape();
+    return shape[0] * shape[1] * shape[2];
+}
+}    // namespace
+
+void get_observation_batch(const RNDGameState *states, std::size_t num_states, float *obs, ThreadPool *pool) noexcept {
+    if (num_states == 0) {
+        return;
+    }
+    const std::size_t obs_size = observation_size(states[0]);
+    for_each_state(num_states, pool, [&](std::size_t n) {
+        assert(observation_size(states[n]) == obs_size);
+        states[n].get_observation(obs + n * obs_size);
+    });
+}
+
+void get_observation_batch(const RNDGameState *states, std::size_t num_states, uint8_t *obs,
+                           ThreadPool *pool) noexcept {
+    if (num_states == 0) {
+        return;
+    }
+    const std::size_t obs_size = observation_size(states[0]);
+    for_each_state(num_states, pool, [&](std::size_t n) {
+        assert(observation_size(states[n]) == obs_size);
+        states[n].get_observation(obs + n * obs_size);
+    });
+}
+
+void get_observation_batch(const RNDGameState *states, std::size_t num_states, const ObservationSpec &spec, float *obs,
+                           ThreadPool *pool) noexcept {
+    if (num_states == 0) {
+        return;
+    }
+    const auto shape = states[0].observation_shape(spec);
+    const std::size_t obs_size = shape[0] * shape[1] * shape[2];
+    for_each_state(num_states, pool, [&](std::size_t n) { states[n].get_observation(spec, obs + n * obs_size); });
+}
+
+void get_observation_batch_packed(const RNDGameState *states, std::size_t num_states, uint8_t *obs,
+                                  ThreadPool *pool) noexcept {
+    if (num_states == 0) {
+        return;
+    }
+    const std::size_t obs_size = states[0].packed_observation_size();
+    for_each_state(num_states, pool, [&](std::size_t n) {
+        assert(states[n].packed_observation_size() == obs_size);
+        states[n].get_observation_packed(obs + n * obs_size);
+    });
+}
+
+}    // namespace stonesngems
@@ -0,0 +1,61 @@
+#ifndef STONESNGEMS_OBSERVATION_H_
+#define STONESNGEMS_OBSERVATION_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+/**
+ * Write the observations of a batch of states into a contiguous N x C x H x W buffer.
+ * @note All states must share the same observation_shape(), and the buffer must hold N * C * H * W elements
+ * @param states Pointer to the first state of the batch
+ * @param num_states Number of states N in the batch
+ * @param obs Pointer to the start of the batch buffer
+ * @param pool Optional thread pool to split the batch across
+ */
+void get_observation_batch(const RNDGameState *states, std::size_t num_states, float *obs,
+                           ThreadPool *pool = nullptr) noexcept;
+
+/**
+ * Write the observations of a batch of states into a contiguous N x C x H x W byte buffer.
+ * @note All states must share the same observation_shape(), and the buffer must hold N * C * H * W elements
+ * @param states Pointer to the first state of the batch
+ * @param num_states Number of states N in the batch
+ * @param obs Pointer to the start of the batch buffer
+ * @param pool Optional thread pool to split the batch across
+ */
+void get_observation_batch(const RNDGameState *states, std::size_t num_states, uint8_t *obs,
+                           ThreadPool *pool = nullptr) noexcept;
+
+/**
+ * Write the filtered observations of a batch of states into a contiguous N x C x H x W buffer.
+ * @note All states must share the same observation_shape(spec), and the buffer must hold N * C * H * W elements
+ * @param states Pointer to the first state of the batch
+ * @param num_states Number of states N in the batch
+ * @param spec The observation spec holding the observed elements
+ * @param obs Pointer to the start of the batch buffer
+ * @param pool Optional thread pool to split the batch across
+ */
+void get_observation_batch(const RNDGameState *states, std::size_t num_states, const ObservationSpec &spec, float *obs,
+                           ThreadPool *pool = nullptr) noexcept;
+
+/**
+ * Write the bit-packed observations of a batch of states into a contiguous buffer.
+ * State n is written starting at byte n * packed_observation_size(), see RNDGameState::get_observation_packed().
+ * @note All states must share the same observation_shape(), and the buffer must hold N * packed_observation_size()
+ * bytes
+ * @param states Pointer to the first state of the batch
+ * @param num_states Number of states N in the batch
+ * @param obs Pointer to the start of the batch buffer
+ * @param pool Optional thread pool to split the batch across
+ */
+void get_observation_batch_packed(const RNDGameState *states, std::size_t num_states, uint8_t *obs,
+                                  ThreadPool *pool = nullptr) noexcept;
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_OBSERVATION_H_
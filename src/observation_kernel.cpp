@@ -0,0 +1,161 @@
+#include "observation_kernel.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define STONESNGEMS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace stonesngems {
+
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers, *-pointer-arithmetic, *-reinterpret-cast)
+
+// ----- Scalar -----
+
+template <typename T>
+void one_hot_planes_scalar(const uint8_t *channels, std::size_t channel_length, std::size_t num_channels,
+                           T *out) noexcept {
+    for (std::size_t c = 0; c < num_channels; ++c) {
+        T *plane = out + c * channel_length;
+        for (std::size_t i = 0; i < channel_length; ++i) {
+            plane[i] = static_cast<T>(channels[i] == c);
+        }
+    }
+}
+
+#ifdef STONESNGEMS_X86_KERNELS
+
+// ----- SSE2 -----
+
+void one_hot_planes_sse2(const uint8_t *channels, std::size_t channel_length, std::size_t num_channels,
+                         float *out) noexcept {
+    const __m128 ones = _mm_set1_ps(1.0F);
+    for (std::size_t c = 0; c < num_channels; ++c) {
+        float *plane = out + c * channel_length;
+        const __m128i channel = _mm_set1_epi8(static_cast<char>(c));
+        std::size_t i = 0;
+        for (; i + 16 <= channel_length; i += 16) {
+            // Byte masks widened to 32-bit masks, then used to select 1.0f
+            const __m128i mask = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(channels + i)),
+                                                channel);
+            const __m128i mask_lo = _mm_unpacklo_epi8(mask, mask);
+            const __m128i mask_hi = _mm_unpackhi_epi8(mask, mask);
+            _mm_storeu_ps(plane + i, _mm_and_ps(_mm_castsi128_ps(_mm_unpacklo_epi16(mask_lo, mask_lo)), ones));
+            _mm_storeu_ps(plane + i + 4, _mm_and_ps(_mm_castsi128_ps(_mm_unpackhi_epi16(mask_lo, mask_lo)), ones));
+            _mm_storeu_ps(plane + i + 8, _mm_and_ps(_mm_castsi128_ps(_mm_unpacklo_epi16(mask_hi, mask_hi)), ones));
+            _mm_storeu_ps(plane + i + 12, _mm_and_ps(_mm_castsi128_ps(_mm_unpackhi_epi16(mask_hi, mask_hi)), ones));
+        }
+        for (; i < channel_length; ++i) {
+            plane[i] = static_cast<float>(channels[i] == c);
+        }
+    }
+}
+
+void one_hot_planes_sse2(const uint8_t *channels, std::size_t channel_length, std::size_t num_channels,
+                         uint8_t *out) noexcept {
+    const __m128i ones = _mm_set1_epi8(1);
+    for (std::size_t c = 0; c < num_channels; ++c) {
+        uint8_t *plane = out + c * channel_length;
+        const __m128i channel = _mm_set1_epi8(static_cast<char>(c));
+        std::size_t i = 0;
+        for (; i + 16 <= channel_length; i += 16) {
+            const __m128i mask = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(channels + i)),
+                                                channel);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(plane + i), _mm_and_si128(mask, ones));
+        }
+        for (; i < channel_length; ++i) {
+            plane[i] = static_cast<uint8_t>(channels[i] == c);
+        }
+    }
+}
+
+// ----- AVX2 -----
+
+__attribute__((target("avx2"))) void one_hot_planes_avx2(const uint8_t *channels, std::size_t channel_length,
+                                                         std::size_t num_channels, float *out) noexcept {
+    const __m256 ones = _mm256_set1_ps(1.0F);
+    for (std::size_t c = 0; c < num_channels; ++c) {
+        float *plane = out + c * channel_length;
+        const __m256i channel = _mm256_set1_epi8(static_cast<char>(c));
+        std::size_t i = 0;
+        for (; i + 32 <= channel_length; i += 32) {
+            // Byte masks sign extended to 32-bit masks, then used to select 1.0f
+            const __m256i mask = _mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(channels + i)), channel);
+            const __m128i mask_lo = _mm256_castsi256_si128(mask);
+            const __m128i mask_hi = _mm256_extracti128_si256(mask, 1);
+            _mm256_storeu_ps(plane + i, _mm256_and_ps(_mm256_castsi256_ps(_mm256_cvtepi8_epi32(mask_lo)), ones));
+            _mm256_storeu_ps(plane + i + 8, _mm256_and_ps(
+                                                _mm256_castsi256_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(mask_lo, 8))),
+                                                ones));
+            _mm256_storeu_ps(plane + i + 16, _mm256_and_ps(_mm256_castsi256_ps(_mm256_cvtepi8_epi32(mask_hi)), ones));
+            _mm256_storeu_ps(plane + i + 24, _mm256_and_ps(
+                                                 _mm256_castsi256_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(mask_hi, 8))),
+                                                 ones));
+        }
+        for (; i < channel_length; ++i) {
+            plane[i] = static_cast<float>(channels[i] == c);
+        }
+    }
+}
+
+__attribute__((target("avx2"))) void one_hot_planes_avx2(const uint8_t *channels, std::size_t channel_length,
+                                                         std::size_t num_channels, uint8_t *out) noexcept {
+    const __m256i ones = _mm256_set1_epi8(1);
+    for (std::size_t c = 0; c < num_channels; ++c) {
+        uint8_t *plane = out + c * channel_length;
+        const __m256i channel = _mm256_set1_epi8(static_cast<char>(c));
+        std::size_t i = 0;
+        for (; i + 32 <= channel_length; i += 32) {
+            const __m256i mask = _mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(channels + i)), channel);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(plane + i), _mm256_and_si256(mask, ones));
+        }
+        for (; i < channel_length; ++i) {
+            plane[i] = static_cast<uint8_t>(channels[i] == c);
+        }
+    }
+}
+
+#endif    // STONESNGEMS_X86_KERNELS
+
+// NOLINTEND(*-magic-numbers, *-pointer-arithmetic, *-reinterpret-cast)
+
+// ----- Runtime dispatch -----
+
+template <typename T>
+using KernelFn = void (*)(const uint8_t *, std::size_t, std::size_t, T *) noexcept;
+
+template <typename T>
+[[nodiscard]] auto select_kernel() noexcept -> KernelFn<T> {
+#ifdef STONESNGEMS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return static_cast<KernelFn<T>>(one_hot_planes_avx2);
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return static_cast<KernelFn<T>>(one_hot_planes_sse2);
+    }
+#endif
+    return one_hot_planes_scalar<T>;
+}
+
+}    // namespace
+
+void write_one_hot_planes(const uint8_t *channels, std::size_t channel_length, std::size_t num_channels,
+                          float *out) noexcept {
+    static const KernelFn<float> kernel = select_kernel<float>();
+    kernel(channels, channel_length, num_channels, out);
+}
+
+void write_one_hot_planes(const uint8_t *channels, std::size_t channel_length, std::size_t num_channels,
+                          uint8_t *out) noexcept {
+    static const KernelFn<uint8_t> kernel = select_kernel<uint8_t>();
+    kernel(channels, channel_length, num_channels, out);
+}
+
+}    // namespace stonesngems
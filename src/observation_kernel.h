@@ -0,0 +1,30 @@
+#ifndef STONESNGEMS_OBSERVATION_KERNEL_H_
+#define STONESNGEMS_OBSERVATION_KERNEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace stonesngems {
+
+/**
+ * Write one-hot channel planes from the per-cell channel IDs, one full plane at a time.
+ * Every element of the output is written, so the buffer does not need to be cleared beforehand.
+ * Uses AVX2 or SSE2 when available on the running CPU, otherwise falls back to a scalar loop.
+ * @param channels Channel ID of each cell, IDs >= num_channels are not observed
+ * @param channel_length Number of cells in each plane (H * W)
+ * @param num_channels Number of planes C to write
+ * @param out Pointer to the start of the C * H * W buffer
+ */
+void write_one_hot_planes(const uint8_t *channels, std::size_t channel_length, std::size_t num_channels,
+                          float *out) noexcept;
+
+/**
+ * Write one-hot channel planes from the per-cell channel IDs, one full plane at a time.
+ * @see write_one_hot_planes
+ */
+void write_one_hot_planes(const uint8_t *channels, std::size_t channel_length, std::size_t num_channels,
+                          uint8_t *out) noexcept;
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_OBSERVATION_KERNEL_H_
@@ -7,25 +7,44 @@ import cv2
 SCRIPT_PATH = os.path.dirname(os.path.abspath(__file__))
 TILES_PATH = os.path.join(os.path.dirname(SCRIPT_PATH), "tiles")
 ASSETS_ALL = os.path.join(SCRIPT_PATH, "assets_all.inc")
+# Tile sizes to generate sprites for, the first is the native tile size
+TILE_SIZES = [32, 16, 8, 4]
 ASSETS_STR = (
     "{0}\n"
     "\n"
-    "const std::unordered_map<VisibleCellType, std::vector<unsigned char>> img_asset_map {{\n"
+    "const std::unordered_map<int, std::unordered_map<VisibleCellType, std::vector<unsigned char>>> img_asset_maps {{\n"
     "{1}"
     "}};\n"
 )
+ASSET_MAP_STR = "{{ {0}, {{\n{1}}} }},\n"
+
+
+def asset_file_name(asset_name, tile_size):
+    # Native size keeps the plain asset name
+    if tile_size == TILE_SIZES[0]:
+        return asset_name
+    return "{}_{}".format(asset_name, tile_size)
 
 
 def main():
-    # asset_headers = ""
-    asset_mappings = ""
+    asset_maps = ""
     assets_data = ""
-    for file in os.listdir(TILES_PATH):
-        if file.endswith(".png"):
+    for tile_size in TILE_SIZES:
+        asset_mappings = ""
+        for file in os.listdir(TILES_PATH):
+            if not file.endswith(".png"):
+                continue
             img = cv2.cvtColor(
                 cv2.imread("{}/{}".format(TILES_PATH, file)), cv2.COLOR_BGR2RGB
-            ).flatten()
-            asset_name = file[:-4]
+            )
+            # Area interpolation averages each block of source pixels when downsampling
+            if img.shape[0] != tile_size or img.shape[1] != tile_size:
+                img = cv2.resize(
+                    img, (tile_size, tile_size), interpolation=cv2.INTER_AREA
+                )
+            img = img.flatten()
+            element_name = file[:-4]
+            asset_name = asset_file_name(element_name, tile_size)
             binary_file_name = asset_name + ".bin"
             binary_file_path = TILES_PATH + "/" + binary_file_name
             img = bytearray(img)
@@ -52,14 +71,16 @@ def main():
 
             # Add to master include list
             internal_name = "VisibleCellType::k" + string.capwords(
-                asset_name.replace("_", " ")
+                element_name.replace("_", " ")
             ).replace(" ", "")
             asset_mappings += "{{ {0}, {1}_bin }},\n".format(internal_name, asset_name)
 
+        asset_maps += ASSET_MAP_STR.format(tile_size, asset_mappings)
+
     # create master include
-    print(ASSETS_STR.format(assets_data, asset_mappings))
+    print(ASSETS_STR.format(assets_data, asset_maps))
     with open(ASSETS_ALL, "w") as f:
-        f.write(ASSETS_STR.format(assets_data, asset_mappings))
+        f.write(ASSETS_STR.format(assets_data, asset_maps))
 
 
 if __name__ == "__main__":
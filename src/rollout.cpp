@@ -0,0 +1,125 @@
+#include "rollout.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "definitions.h"
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+namespace {
+constexpr uint64_t kPlayoutSeedMultiplier = 0xD1B54A32D192ED03ULL;
+constexpr int kBitsPerHalfWord = 32;
+
+// splitmix64, used as the per-playout generator so playouts never touch the random state of the game
+auto splitmix64(uint64_t &s) noexcept -> uint64_t {
+    uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;    // NOLINT(*-magic-numbers)
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;    // NOLINT(*-magic-numbers)
+    return z ^ (z >> 31);                           // NOLINT(*-magic-numbers)
+}
+
+// Uniform index in [0, n) from the high bits of the generator, without a division
+auto random_index(uint64_t &rng, std::size_t n) noexcept -> std::size_t {
+    return static_cast<std::size_t>(((splitmix64(rng) >> kBitsPerHalfWord) * n) >> kBitsPerHalfWord);
+}
+}    // namespace
+
+RolloutEngine::RolloutEngine(std::size_t num_threads)
+    : pool(num_threads == 1 ? nullptr : std::make_unique<ThreadPool>(num_threads)),
+      workers(pool ? pool->num_threads() : 1) {
+    for (auto &worker : workers) {
+        worker.actions.reserve(kNumActions);
+        worker.safe_actions.reserve(kNumActions);
+    }
+}
+
+auto RolloutEngine::num_threads() const noexcept -> std::size_t {
+    return workers.size();
+}
+
+auto RolloutEngine::run(const RNDGameState &state, const RolloutOptions &options) -> RolloutStats {
+    for (auto &worker : workers) {
+        if (!worker.scratch) {
+            worker.scratch = std::make_unique<RNDGameState>(state);
+        }
+        worker.stats = {};
+        worker.stats.max_return = std::numeric_limits<double>::lowest();
+    }
+    if (pool) {
+        pool->parallel_for(options.num_playouts, [&](std::size_t begin, std::size_t end, std::size_t worker_idx) {
+            RunSlice(state, options, begin, end, workers[worker_idx]);
+        });
+    } else {
+        RunSlice(state, options, 0, options.num_playouts, workers.front());
+    }
+
+    RolloutStats stats;
+    stats.max_return = std::numeric_limits<double>::lowest();
+    for (const auto &worker : workers) {
+        stats.num_playouts += worker.stats.num_playouts;
+        stats.num_solved += worker.stats.num_solved;
+        stats.num_terminal += worker.stats.num_terminal;
+        stats.total_return += worker.stats.total_return;
+        stats.max_return = std::max(stats.max_return, worker.stats.max_return);
+        stats.total_depth += worker.stats.total_depth;
+    }
+    if (stats.num_playouts == 0) {
+        stats.max_return = 0;
+    }
+    return stats;
+}
+
+void RolloutEngine::RunSlice(const RNDGameState &state, const RolloutOptions &options, std::size_t begin,
+                             std::size_t end, Worker &worker) noexcept {
+    RNDGameState &scratch = *worker.scratch;
+    for (std::size_t i = begin; i < end; ++i) {
+        // Copy assignment reuses the scratch buffers
+        scratch = state;
+        uint64_t seed = options.seed ^ (i * kPlayoutSeedMultiplier);
+        uint64_t rng = splitmix64(seed);
+        double playout_return = 0;
+        double weight = 1;
+        std::size_t depth = 0;
+        // Reaching the exit is not terminal in itself, so solutions end the playout separately
+        while (!scratch.is_terminal() && !scratch.is_solution() &&
+               (options.max_depth == 0 || depth < options.max_depth)) {
+            Action action = Action::kNoop;
+            if (options.policy == RolloutPolicy::kUniform) {
+                action = RNDGameState::ALL_ACTIONS[random_index(rng, kNumActions)];
+            } else {
+                scratch.legal_actions(worker.actions, true);
+                const std::vector<Action> *choices = &worker.actions;
+                if (options.policy == RolloutPolicy::kSafe) {
+                    worker.safe_actions.clear();
+                    for (const auto a : worker.actions) {
+                        if (!scratch.is_action_fatal(a)) {
+                            worker.safe_actions.push_back(a);
+                        }
+                    }
+                    choices = worker.safe_actions.empty() ? choices : &worker.safe_actions;
+                }
+                action = (*choices)[random_index(rng, choices->size())];
+            }
+            scratch.apply_action(action);
+            playout_return += weight * scratch.get_current_reward();
+            weight *= options.discount;
+            ++depth;
+        }
+        ++worker.stats.num_playouts;
+        const bool solved = scratch.is_solution();
+        worker.stats.num_solved += static_cast<std::size_t>(solved);
+        worker.stats.num_terminal += static_cast<std::size_t>(solved || scratch.is_terminal());
+        worker.stats.total_return += playout_return;
+        worker.stats.max_return = std::max(worker.stats.max_return, playout_return);
+        worker.stats.total_depth += depth;
+    }
+}
+
+}    // namespace stonesngems
@@ -0,0 +1,94 @@
+#ifndef STONESNGEMS_ROLLOUT_H_
+#define STONESNGEMS_ROLLOUT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "definitions.h"
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+// How playouts pick their random actions
+enum class RolloutPolicy {
+    kUniform = 0,    // Uniform over all actions
+    kPruned = 1,     // Uniform over legal_actions(true), skipping actions equivalent to kNoop
+    kSafe = 2,       // As kPruned, also skipping actions which are certain to be fatal unless all of them are
+};
+
+struct RolloutOptions {
+    std::size_t num_playouts = 64;                     // Number of playouts M
+    std::size_t max_depth = 100;                       // Maximum number of steps per playout, 0 for no limit
+    uint64_t seed = 0;                                 // Playout i draws from a generator seeded by seed and i
+    RolloutPolicy policy = RolloutPolicy::kUniform;    // How playouts pick their actions
+    double discount = 1;                               // Discount applied to the reward of each later step
+};
+
+// Statistics aggregated over all playouts
+struct RolloutStats {
+    std::size_t num_playouts = 0;
+    std::size_t num_solved = 0;      // Playouts which reached a solution
+    std::size_t num_terminal = 0;    // Playouts which reached any terminal state, including solutions
+    double total_return = 0;         // Sum of the discounted returns
+    double max_return = 0;           // Best discounted return of a single playout
+    std::size_t total_depth = 0;     // Sum of the playout lengths in steps
+
+    [[nodiscard]] auto mean_return() const noexcept -> double {
+        return num_playouts > 0 ? total_return / static_cast<double>(num_playouts) : 0;
+    }
+    [[nodiscard]] auto solve_rate() const noexcept -> double {
+        return num_playouts > 0 ? static_cast<double>(num_solved) / static_cast<double>(num_playouts) : 0;
+    }
+    [[nodiscard]] auto mean_depth() const noexcept -> double {
+        return num_playouts > 0 ? static_cast<double>(total_depth) / static_cast<double>(num_playouts) : 0;
+    }
+};
+
+// Runs batches of random playouts from a root state.
+// Every worker keeps a scratch state which is copy-assigned from the root at the start of each playout, so once the
+// scratch states hold a board of the same size as the root, playouts do not allocate.
+// Playouts use their own generator, independent of the random state the game uses for blobs and magic walls, and the
+// results do not depend on the number of threads.
+class RolloutEngine {
+public:
+    /**
+     * Create the engine.
+     * @param num_threads Number of worker threads, 0 uses the hardware concurrency
+     */
+    explicit RolloutEngine(std::size_t num_threads = 1);
+
+    /**
+     * Get the number of worker threads.
+     * @return Number of workers
+     */
+    [[nodiscard]] auto num_threads() const noexcept -> std::size_t;
+
+    /**
+     * Run playouts from the given state.
+     * @param state The root state, which is left unchanged
+     * @param options Rollout options
+     * @return Statistics over all playouts
+     */
+    [[nodiscard]] auto run(const RNDGameState &state, const RolloutOptions &options = {}) -> RolloutStats;
+
+private:
+    struct Worker {
+        std::unique_ptr<RNDGameState> scratch;
+        std::vector<Action> actions;
+        std::vector<Action> safe_actions;
+        RolloutStats stats;
+    };
+
+    void RunSlice(const RNDGameState &state, const RolloutOptions &options, std::size_t begin, std::size_t end,
+                  Worker &worker) noexcept;
+
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<Worker> workers;
+};
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_ROLLOUT_H_
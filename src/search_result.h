@@ -0,0 +1,27 @@
+#ifndef STONESNGEMS_SEARCH_RESULT_H_
+#define STONESNGEMS_SEARCH_RESULT_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "definitions.h"
+
+namespace stonesngems {
+
+// Outcome and statistics of a solver run
+struct SearchResult {
+    bool solved = false;             // True if a solution was found
+    bool hit_limit = false;          // True if the search stopped on a depth, node, or memory limit
+    std::vector<Action> solution;    // Actions from the root state to the solution state
+    std::size_t nodes_expanded = 0;
+    std::size_t nodes_generated = 0;
+    double seconds = 0;
+
+    [[nodiscard]] auto nodes_per_second() const noexcept -> double {
+        return seconds > 0 ? static_cast<double>(nodes_expanded) / seconds : 0;
+    }
+};
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_SEARCH_RESULT_H_
@@ -0,0 +1,102 @@
+#include "sprite_atlas.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "definitions.h"
+
+namespace stonesngems {
+
+// VisibleCellType to image binary data
+#include "assets_all.inc"
+
+namespace {
+constexpr std::size_t ATLAS_ALIGNMENT = 64;
+constexpr std::size_t NUM_ATLAS_SPRITES = kNumVisibleCellType + 1;
+
+constexpr auto sprite_len(std::size_t tile_size) noexcept -> std::size_t {
+    return tile_size * tile_size * SPRITE_CHANNELS;
+}
+
+// Offset of each tile size's sprites, in SPRITE_TILE_SIZES order
+constexpr auto make_atlas_offsets() noexcept -> std::array<std::size_t, SPRITE_TILE_SIZES.size() + 1> {
+    std::array<std::size_t, SPRITE_TILE_SIZES.size() + 1> offsets{};
+    for (std::size_t i = 0; i < SPRITE_TILE_SIZES.size(); ++i) {
+        offsets[i + 1] = offsets[i] + NUM_ATLAS_SPRITES * sprite_len(SPRITE_TILE_SIZES[i]);    // NOLINT
+    }
+    return offsets;
+}
+constexpr auto ATLAS_OFFSETS = make_atlas_offsets();
+
+auto tile_size_index(std::size_t tile_size) noexcept -> std::size_t {
+    std::size_t idx = 0;
+    while (idx < SPRITE_TILE_SIZES.size() && SPRITE_TILE_SIZES[idx] != tile_size) {    // NOLINT
+        ++idx;
+    }
+    return idx;
+}
+
+[[nodiscard]] auto is_valid_element(VisibleCellType element) noexcept -> bool {
+    return static_cast<int>(element) >= 0 && static_cast<int>(element) < kNumVisibleCellType;
+}
+
+// For each tile size, all sprites stored back to back in VisibleCellType order followed by a black sprite for
+// missing assets
+struct SpriteAtlas {
+    SpriteAtlas() noexcept {
+        data.fill(0);
+        for (const auto &[tile_size, asset_map] : img_asset_maps) {
+            const std::size_t size_idx = tile_size_index(static_cast<std::size_t>(tile_size));
+            if (size_idx == SPRITE_TILE_SIZES.size()) {
+                continue;
+            }
+            const std::size_t len = sprite_len(static_cast<std::size_t>(tile_size));
+            for (const auto &[element, sprite] : asset_map) {
+                if (is_valid_element(element) && sprite.size() == len) {
+                    // NOLINTNEXTLINE(*-bounds-constant-array-index)
+                    const std::size_t offset = ATLAS_OFFSETS[size_idx] + static_cast<std::size_t>(element) * len;
+                    std::copy(sprite.begin(), sprite.end(), data.begin() + static_cast<std::ptrdiff_t>(offset));
+                }
+            }
+        }
+    }
+
+    alignas(ATLAS_ALIGNMENT) std::array<uint8_t, ATLAS_OFFSETS.back()> data{};
+};
+
+auto atlas() noexcept -> const SpriteAtlas & {
+    static const SpriteAtlas sprite_atlas;
+    return sprite_atlas;
+}
+}    // namespace
+
+auto is_valid_tile_size(std::size_t tile_size) noexcept -> bool {
+    return tile_size_index(tile_size) < SPRITE_TILE_SIZES.size();
+}
+
+auto get_sprite(VisibleCellType element, std::size_t tile_size) noexcept -> const uint8_t * {
+    assert(is_valid_tile_size(tile_size));
+    const auto element_idx = static_cast<uint8_t>(element);
+    const std::size_t sprite_idx = element_idx < kNumVisibleCellType ? element_idx : kNumVisibleCellType;
+    const std::size_t offset = ATLAS_OFFSETS[tile_size_index(tile_size)];    // NOLINT(*-bounds-constant-array-index)
+    return atlas().data.data() + offset + sprite_idx * sprite_len(tile_size);
+}
+
+void draw_sprite(uint8_t *img, std::size_t img_cols, std::size_t row, std::size_t col, VisibleCellType element,
+                 std::size_t tile_size) noexcept {
+    const uint8_t *sprite = get_sprite(element, tile_size);
+    const std::size_t sprite_row_len = tile_size * SPRITE_CHANNELS;
+    const std::size_t img_row_len = img_cols * sprite_row_len;
+    uint8_t *tile_top_left = img + row * tile_size * img_row_len + col * sprite_row_len;
+    for (std::size_t r = 0; r < tile_size; ++r) {
+        std::memcpy(tile_top_left + r * img_row_len, sprite + r * sprite_row_len, sprite_row_len);
+    }
+}
+
+}    // namespace stonesngems
@@ -0,0 +1,52 @@
+#ifndef STONESNGEMS_SPRITE_ATLAS_H_
+#define STONESNGEMS_SPRITE_ATLAS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "definitions.h"
+
+namespace stonesngems {
+
+constexpr int SPRITE_WIDTH = 32;
+constexpr int SPRITE_HEIGHT = 32;
+constexpr int SPRITE_CHANNELS = 3;
+constexpr int SPRITE_DATA_LEN_PER_ROW = SPRITE_WIDTH * SPRITE_CHANNELS;
+constexpr int SPRITE_DATA_LEN = SPRITE_WIDTH * SPRITE_HEIGHT * SPRITE_CHANNELS;
+
+// Supported square tile sizes in pixels, the first is the native sprite size the others are downsampled from
+constexpr std::array<std::size_t, 4> SPRITE_TILE_SIZES = {32, 16, 8, 4};
+
+/**
+ * Check if sprites are available for the given tile size.
+ * @param tile_size Tile width and height in pixels
+ * @return True if the tile size is one of SPRITE_TILE_SIZES
+ */
+[[nodiscard]] auto is_valid_tile_size(std::size_t tile_size) noexcept -> bool;
+
+/**
+ * Get the sprite data for the given visible element, from a contiguous atlas indexed by VisibleCellType.
+ * Elements without an image asset (such as kNull) get a black sprite.
+ * @param element The visible element
+ * @param tile_size Tile width and height in pixels, must be one of SPRITE_TILE_SIZES
+ * @return Pointer to the HWC sprite data, tile_size * tile_size * SPRITE_CHANNELS bytes long
+ */
+[[nodiscard]] auto get_sprite(VisibleCellType element, std::size_t tile_size = SPRITE_WIDTH) noexcept
+    -> const uint8_t *;
+
+/**
+ * Copy the sprite of the given element into the tile at (row, col) of a flat HWC image, one sprite row at a time.
+ * @param img Pointer to the start of the image
+ * @param img_cols Number of tile columns in the image
+ * @param row Tile row to draw into
+ * @param col Tile column to draw into
+ * @param element The visible element to draw
+ * @param tile_size Tile width and height in pixels, must be one of SPRITE_TILE_SIZES
+ */
+void draw_sprite(uint8_t *img, std::size_t img_cols, std::size_t row, std::size_t col, VisibleCellType element,
+                 std::size_t tile_size = SPRITE_WIDTH) noexcept;
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_SPRITE_ATLAS_H_
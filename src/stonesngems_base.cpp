@@ -9,28 +9,74 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <climits>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iostream>
-#include <iterator>
 #include <limits>
 #include <memory>
 #include <random>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "definitions.h"
+#include "distance_map.h"
+#include "observation_kernel.h"
+#include "sprite_atlas.h"
 #include "util.h"
 
 namespace stonesngems {
 
+ObservationSpec::ObservationSpec(const std::vector<VisibleCellType> &filter_elements) {
+    channel_map.fill(kNoChannel);
+    for (const auto &element : filter_elements) {
+        assert(RNDGameState::is_valid_visible_element(element));
+        assert(num_channels < kNoChannel);
+        // Keep the first occurrence so duplicates don't shift the channel order
+        if (channel(element) == kNoChannel) {
+            channel_map[static_cast<std::size_t>(element)] = static_cast<uint8_t>(num_channels);
+        }
+        ++num_channels;
+    }
+}
+
 RNDGameState::RNDGameState(const GameParameters &params) : shared_state_ptr(std::make_shared<SharedStateInfo>(params)) {
     reset();
 }
 
+RNDGameState::RNDGameState(const RNDGameState &other)
+    : shared_state_ptr(other.shared_state_ptr), board(other.board), local_state(other.local_state) {
+    BindCells();
+}
+
+RNDGameState::RNDGameState(RNDGameState &&other) noexcept
+    : shared_state_ptr(std::move(other.shared_state_ptr)),
+      board(std::move(other.board)),
+      local_state(std::move(other.local_state)) {
+    BindCells();
+}
+
+auto RNDGameState::operator=(const RNDGameState &other) -> RNDGameState & {
+    shared_state_ptr = other.shared_state_ptr;
+    board = other.board;
+    local_state = other.local_state;
+    BindCells();
+    return *this;
+}
+
+auto RNDGameState::operator=(RNDGameState &&other) noexcept -> RNDGameState & {
+    shared_state_ptr = std::move(other.shared_state_ptr);
+    board = std::move(other.board);
+    local_state = std::move(other.local_state);
+    BindCells();
+    return *this;
+}
+
 auto RNDGameState::operator==(const RNDGameState &other) const noexcept -> bool {
     return local_state == other.local_state && board == other.board;
 }
@@ -90,6 +136,8 @@ RNDGameState::RNDGameState(const std::vector<uint8_t> &byte_data)
     SharedStateInfo &info = *shared_state_ptr;
     deserializer.Read(&info);
     deserializer.Read(&board);
+    board.clear_step_state();
+    BindCells();
     InitZrbhtTable();
 }
 
@@ -115,6 +163,24 @@ auto RNDGameState::serialize() const -> std::vector<uint8_t> {
     return byte_data;
 }
 
+auto RNDGameState::serialize_local() const -> std::vector<uint8_t> {
+    nop::Serializer<nop::StreamWriter<std::stringstream>> serializer;
+    serializer.Write(local_state);
+    serializer.Write(board);
+    const std::string data = serializer.writer().stream().str();
+    return {data.begin(), data.end()};
+}
+
+void RNDGameState::deserialize_local(const std::vector<uint8_t> &byte_data) {
+    std::stringstream ss;
+    ss.write(reinterpret_cast<char const *>(byte_data.data()), std::streamsize(byte_data.size()));
+    nop::Deserializer<nop::StreamReader<std::stringstream>> deserializer{std::move(ss)};
+    deserializer.Read(&local_state);
+    deserializer.Read(&board);
+    board.clear_step_state();
+    BindCells();
+}
+
 void RNDGameState::InitZrbhtTable() noexcept {
     // zorbist hashing
     std::mt19937 gen(static_cast<unsigned long>(shared_state_ptr->rng_seed));
@@ -126,9 +192,14 @@ void RNDGameState::InitZrbhtTable() noexcept {
     }
 }
 
+void RNDGameState::BindCells() noexcept {
+    cells = BoardView(board);
+}
+
 void RNDGameState::reset() {
     // Board, local, and shared state info
     board = parse_board_str(shared_state_ptr->game_board_str);
+    BindCells();
     local_state = LocalState();
     local_state.random_state = splitmix64(static_cast<uint64_t>(shared_state_ptr->rng_seed));
     local_state.steps_remaining = board.max_steps;
@@ -182,61 +253,215 @@ void RNDGameState::apply_action(Action action) {
 
     // Handle all other items
     for (std::size_t i = 0; i < board.rows * board.cols; ++i) {
-        if (board.has_updated[i]) {    // Item already updated
+        if (cells.updated(i)) {    // Item already updated
             continue;
         }
-        switch (board.item(i)) {
-            // Handle non-compound types
-            case HiddenCellType::kStone:
-                UpdateStone(i);
-                break;
-            case HiddenCellType::kStoneFalling:
-                UpdateStoneFalling(i);
-                break;
-            case HiddenCellType::kDiamond:
-                UpdateDiamond(i);
-                break;
-            case HiddenCellType::kDiamondFalling:
-                UpdateDiamondFalling(i);
-                break;
-            case HiddenCellType::kNut:
-                UpdateNut(i);
-                break;
-            case HiddenCellType::kNutFalling:
-                UpdateNutFalling(i);
-                break;
-            case HiddenCellType::kBomb:
-                UpdateBomb(i);
-                break;
-            case HiddenCellType::kBombFalling:
-                UpdateBombFalling(i);
-                break;
-            case HiddenCellType::kExitClosed:
-                UpdateExit(i);
-                break;
-            case HiddenCellType::kBlob:
-                UpdateBlob(i);
-                break;
-            default:
-                // Handle compound types
-                // NOLINTNEXTLINE(*-bounds-constant-array-index)
-                const Element &element = kCellTypeToElement[static_cast<std::size_t>(board.item(i)) + 1];
-                if (IsButterfly(element)) {
-                    UpdateButterfly(i, kButterflyToDirection.at(element));
-                } else if (IsFirefly(element)) {
-                    UpdateFirefly(i, kFireflyToDirection.at(element));
-                } else if (IsOrange(element)) {
-                    UpdateOrange(i, kOrangeToDirection.at(element));
-                } else if (IsMagicWall(element)) {
-                    UpdateMagicWall(i);
-                } else if (IsExplosion(element)) {
-                    UpdateExplosions(i);
+        UpdateCell(i);
+    }
+
+    EndScan();
+}
+
+auto RNDGameState::apply_path_to(std::size_t target_index) -> PathResult {
+    assert(target_index < board.rows * board.cols);
+    PathResult result;
+    const std::size_t start = board.agent_idx;
+    if (board.agent_pos != start || is_terminal()) {
+        return result;
+    }
+    if (start == target_index) {
+        result.reached = true;
+        return result;
+    }
+
+    // Cells the agent can walk through without triggering anything: nothing can fall on it and no creature touches it
+    const auto is_safe = [&](std::size_t index) noexcept -> bool {
+        const Element &element = GetItem(index);
+        const bool collectable = element == kElDiamond || IsKey(element) || element == kElExitOpen;
+        if (!(element == kElEmpty || element == kElDirt || (index == target_index && collectable))) {
+            return false;
+        }
+        if (InBounds(index, Direction::kUp)) {
+            const Element &above = GetItem(index, Direction::kUp);
+            if (kElToFalling.find(above) != kElToFalling.end() || above == kElStoneFalling ||
+                above == kElDiamondFalling || above == kElNutFalling || above == kElBombFalling) {
+                return false;
+            }
+        }
+        for (const auto direction : {Direction::kUp, Direction::kRight, Direction::kDown, Direction::kLeft}) {
+            if (InBounds(index, direction)) {
+                const Element &neighbour = GetItem(index, direction);
+                if (IsFirefly(neighbour) || IsButterfly(neighbour) || IsOrange(neighbour)) {
+                    return false;
                 }
-                break;
+            }
+        }
+        return true;
+    };
+
+    // BFS from the agent, parents record the action which entered each cell
+    constexpr std::size_t kUnvisited = std::numeric_limits<std::size_t>::max();
+    thread_local std::vector<std::size_t> parents;
+    thread_local std::vector<std::size_t> queue;
+    thread_local std::vector<std::size_t> path;
+    thread_local std::vector<std::size_t> guarded_until;
+    const std::size_t num_cells = board.rows * board.cols;
+    parents.assign(num_cells, kUnvisited);
+    queue.assign(1, start);
+    parents[start] = start;
+    for (std::size_t k = 0; k < queue.size() && parents[target_index] == kUnvisited; ++k) {
+        const std::size_t index = queue[k];
+        for (const auto direction : {Direction::kUp, Direction::kRight, Direction::kDown, Direction::kLeft}) {
+            if (!InBounds(index, direction)) {
+                continue;
+            }
+            const std::size_t new_index = IndexFromDirection(index, direction);
+            if (parents[new_index] == kUnvisited && is_safe(new_index)) {
+                parents[new_index] = index;
+                queue.push_back(new_index);
+            }
+        }
+    }
+    if (parents[target_index] == kUnvisited) {
+        return result;
+    }
+    path.clear();
+    for (std::size_t index = target_index; index != start; index = parents[index]) {
+        path.push_back(index);
+    }
+    std::reverse(path.begin(), path.end());
+
+    // Cells around the path, marked with the last step they are next to, so a change to them while the agent has not
+    // passed them yet is unexpected
+    guarded_until.assign(num_cells, 0);
+    for (std::size_t step = 0; step < path.size(); ++step) {
+        const std::size_t row = path[step] / board.cols;
+        const std::size_t col = path[step] % board.cols;
+        for (std::size_t r = (row > 0) ? row - 1 : 0; r <= std::min(row + 1, board.rows - 1); ++r) {
+            for (std::size_t c = (col > 0) ? col - 1 : 0; c <= std::min(col + 1, board.cols - 1); ++c) {
+                guarded_until[r * board.cols + c] = step + 1;
+            }
         }
     }
 
-    EndScan();
+    std::size_t from = start;
+    for (std::size_t step = 0; step < path.size(); ++step) {
+        const std::size_t to = path[step];
+        Action action = Action::kNoop;
+        if (to + board.cols == from) {
+            action = Action::kUp;
+        } else if (to == from + 1) {
+            action = Action::kRight;
+        } else if (to == from + board.cols) {
+            action = Action::kDown;
+        } else {
+            action = Action::kLeft;
+        }
+        if (is_action_fatal(action)) {
+            break;
+        }
+        apply_action(action);
+        ++result.ticks;
+        result.reward_signal |= local_state.reward_signal;
+        result.reward += local_state.current_reward;
+        if (board.agent_idx != to || board.agent_pos == kAgentPosDie || local_state.reward_signal != 0 ||
+            is_terminal()) {
+            break;
+        }
+        const bool unexpected = std::any_of(board.changed_cells.begin(), board.changed_cells.end(), [&](const auto &c) {
+            return c.index != from && c.index != to && guarded_until[c.index] > step + 1;
+        });
+        if (unexpected) {
+            break;
+        }
+        from = to;
+    }
+    result.reached = board.agent_idx == target_index && board.agent_pos != kAgentPosDie;
+    return result;
+}
+
+namespace {
+auto is_unsettled(HiddenCellType item) noexcept -> bool {
+    switch (item) {
+        case HiddenCellType::kStoneFalling:
+        case HiddenCellType::kDiamondFalling:
+        case HiddenCellType::kNutFalling:
+        case HiddenCellType::kBombFalling:
+        case HiddenCellType::kExplosionDiamond:
+        case HiddenCellType::kExplosionBoulder:
+        case HiddenCellType::kExplosionEmpty:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Elements which write to the board on every tick, so it never goes quiet while they are around
+auto is_perpetual(HiddenCellType item) noexcept -> bool {
+    // NOLINTNEXTLINE(*-bounds-constant-array-index)
+    const Element &element = kCellTypeToElement[static_cast<std::size_t>(item) + 1];
+    return element == kElBlob || IsFirefly(element) || IsButterfly(element) || IsOrange(element);
+}
+}    // namespace
+
+auto RNDGameState::advance_until_stable(std::size_t max_ticks) -> StableResult {
+    thread_local std::vector<std::size_t> tracked;    // Unsettled and perpetual cells, scanned on every tick
+    thread_local std::vector<std::size_t> seeds;
+    StableResult result;
+    int num_unsettled = 0;
+    int num_perpetual = 0;
+    tracked.clear();
+    for (std::size_t i = 0; i < board.rows * board.cols; ++i) {
+        const bool unsettled = is_unsettled(board.item(i));
+        const bool perpetual = is_perpetual(board.item(i));
+        num_unsettled += static_cast<int>(unsettled);
+        num_perpetual += static_cast<int>(perpetual);
+        if (unsettled || perpetual) {
+            tracked.push_back(i);
+        }
+    }
+    while (num_unsettled > 0 && result.ticks < max_ticks && !is_terminal()) {
+        if (result.ticks == 0) {
+            // The state may come from a constructor or deserialize with no record of its last step, so the first tick
+            // scans the whole board. Afterwards every cell which is not tracked and not next to a changed cell did
+            // nothing on its last scan and sees the same neighbours, so it would do nothing again.
+            apply_action(Action::kNoop);
+        } else {
+            seeds = tracked;
+            for (const auto &changed : board.changed_cells) {
+                AddNeighbourhood(changed.index, 0, seeds);
+            }
+            ApplyNoopActive(seeds);
+        }
+        ++result.ticks;
+        result.reward_signal |= local_state.reward_signal;
+        result.reward += local_state.current_reward;
+        // Only written cells can have changed type
+        std::size_t num_kept = 0;
+        for (const auto index : tracked) {
+            if (!board.has_changed[index]) {
+                tracked[num_kept++] = index;
+            }
+        }
+        tracked.resize(num_kept);
+        for (const auto &changed : board.changed_cells) {
+            const HiddenCellType item = board.item(changed.index);
+            const bool unsettled = is_unsettled(item);
+            const bool perpetual = is_perpetual(item);
+            num_unsettled += static_cast<int>(unsettled) - static_cast<int>(is_unsettled(changed.previous));
+            num_perpetual += static_cast<int>(perpetual) - static_cast<int>(is_perpetual(changed.previous));
+            if (unsettled || perpetual) {
+                tracked.push_back(changed.index);
+            }
+        }
+        // Unless blobs are around, whose growth depends on the rng, a tick which writes nothing repeats forever
+        if (board.changed_cells.empty() && num_perpetual == 0) {
+            break;
+        }
+    }
+    result.stable = num_unsettled == 0;
+    result.perpetual = num_perpetual > 0;
+    return result;
 }
 
 auto RNDGameState::is_terminal() const noexcept -> bool {
@@ -251,58 +476,369 @@ auto RNDGameState::is_solution() const noexcept -> bool {
     return !out_of_time && board.agent_pos == kAgentPosExit;
 }
 
-auto RNDGameState::legal_actions() const noexcept -> std::vector<Action> {
-    return {Action::kNoop, Action::kUp, Action::kRight, Action::kDown, Action::kLeft};
+namespace {
+// Upper bound on the diamonds a butterfly turns into, its explosion fills the 3x3 block around it
+constexpr int kButterflyDiamonds = 9;
+}    // namespace
+
+auto RNDGameState::is_provably_unsolvable() const noexcept -> bool {
+    if (is_solution()) {
+        return false;
+    }
+    if (is_terminal()) {
+        return true;
+    }
+
+    // Count the diamonds which can still appear: every diamond comes from one already on the board, a nut, a
+    // butterfly, a stone falling through a magic wall, or a blob
+    int diamonds = 0;
+    int stones = 0;
+    int blobs = 0;
+    bool has_magic_wall = false;
+    bool has_exit = false;
+    for (std::size_t i = 0; i < board.rows * board.cols; ++i) {
+        switch (board.item(i)) {
+            case HiddenCellType::kDiamond:
+            case HiddenCellType::kDiamondFalling:
+            case HiddenCellType::kExplosionDiamond:
+            case HiddenCellType::kNut:
+            case HiddenCellType::kNutFalling:
+                ++diamonds;
+                break;
+            case HiddenCellType::kButterflyUp:
+            case HiddenCellType::kButterflyLeft:
+            case HiddenCellType::kButterflyDown:
+            case HiddenCellType::kButterflyRight:
+                diamonds += kButterflyDiamonds;
+                break;
+            case HiddenCellType::kStone:
+            case HiddenCellType::kStoneFalling:
+            case HiddenCellType::kExplosionBoulder:
+                ++stones;
+                break;
+            case HiddenCellType::kBlob:
+                ++blobs;
+                break;
+            case HiddenCellType::kWallMagicOn:
+            case HiddenCellType::kWallMagicDormant:
+                has_magic_wall = true;
+                break;
+            case HiddenCellType::kExitClosed:
+            case HiddenCellType::kExitOpen:
+                has_exit = true;
+                break;
+            default:
+                break;
+        }
+    }
+    // Exits are never created or destroyed
+    if (!has_exit) {
+        return true;
+    }
+    const bool magic_available = has_magic_wall && local_state.magic_wall_steps > 0;
+    // Growing blobs, or blobs of stones next to a working magic wall, give no useful bound
+    const bool blobs_unbounded =
+        blobs > 0 && (local_state.blob_swap == HiddenCellType::kNull ||
+                      (local_state.blob_swap == HiddenCellType::kStone && magic_available));
+    if (!blobs_unbounded) {
+        diamonds += (local_state.blob_swap == HiddenCellType::kDiamond) ? blobs : 0;
+        diamonds += magic_available ? stones + blobs : 0;
+        if (diamonds < board.gems_required - local_state.gems_collected) {
+            return true;
+        }
+    }
+
+    // Layered BFS from the agent through everything but steel walls, the only cells which never change. Walking
+    // through a gate moves two cells in one step, so entering a gate cell is free and it joins the current layer.
+    thread_local std::vector<uint8_t> visited;
+    thread_local std::vector<std::size_t> layer;
+    thread_local std::vector<std::size_t> next_layer;
+    visited.assign(board.rows * board.cols, 0);
+    layer.assign(1, board.agent_idx);
+    visited[board.agent_idx] = 1;
+    const int steps_limit = (board.max_steps > 0) ? local_state.steps_remaining - 1 : std::numeric_limits<int>::max();
+    for (int distance = 0; !layer.empty() && distance <= steps_limit; ++distance) {
+        next_layer.clear();
+        for (std::size_t k = 0; k < layer.size(); ++k) {
+            const std::size_t index = layer[k];
+            const HiddenCellType item = board.item(index);
+            if (item == HiddenCellType::kExitClosed || item == HiddenCellType::kExitOpen) {
+                return false;
+            }
+            for (const auto direction : {Direction::kUp, Direction::kRight, Direction::kDown, Direction::kLeft}) {
+                if (!InBounds(index, direction)) {
+                    continue;
+                }
+                const std::size_t new_index = IndexFromDirection(index, direction);
+                if (visited[new_index] != 0 || board.item(new_index) == HiddenCellType::kWallSteel) {
+                    continue;
+                }
+                visited[new_index] = 1;
+                const Element &element = GetItem(new_index);
+                (IsOpenGate(element) || IsClosedGate(element) ? layer : next_layer).push_back(new_index);
+            }
+        }
+        std::swap(layer, next_layer);
+    }
+    return true;
+}
+
+auto RNDGameState::legal_actions(bool pruned) const noexcept -> std::vector<Action> {
+    if (!pruned) {
+        return {Action::kNoop, Action::kUp, Action::kRight, Action::kDown, Action::kLeft};
+    }
+    std::vector<Action> actions;
+    legal_actions(actions, pruned);
+    return actions;
 }
 
-void RNDGameState::legal_actions(std::vector<Action> &actions) const noexcept {
+void RNDGameState::legal_actions(std::vector<Action> &actions, bool pruned) const noexcept {
     actions.clear();
     for (const auto &a : ALL_ACTIONS) {
+        // Blocked moves write nothing during the agent update, so the rest of the tick matches kNoop
+        if (pruned && a != Action::kNoop && IsAgentBlocked(action_to_direction(a))) {
+            continue;
+        }
         actions.push_back(a);
     }
 }
 
+auto RNDGameState::is_action_fatal(Action action) const noexcept -> bool {
+    assert(is_valid_action(action));
+    const std::size_t index = board.agent_idx;
+    if (board.agent_pos != index || board.item(index) != HiddenCellType::kAgent) {
+        return false;
+    }
+    // Find where the agent ends after its update, only for moves which touch no other cells
+    const Direction direction = action_to_direction(action);
+    std::size_t agent_index = index;
+    if (direction != Direction::kNoop && !IsAgentBlocked(direction)) {
+        const Element &element = GetItem(index, direction);
+        const std::size_t new_index = IndexFromDirection(index, direction);
+        if (element == kElEmpty || element == kElDirt || element == kElDiamond || element == kElDiamondFalling ||
+            IsKey(element)) {
+            agent_index = new_index;
+        } else if (IsOpenGate(element)) {
+            agent_index = IndexFromDirection(new_index, direction);
+        } else {
+            // Pushes and walking into the exit
+            return false;
+        }
+    }
+
+    // Falling elements explode when landing on the agent
+    if (InBounds(agent_index, Direction::kUp)) {
+        const std::size_t index_above = IndexFromDirection(agent_index, Direction::kUp);
+        const HiddenCellType above = (index_above == index) ? HiddenCellType::kEmpty : board.item(index_above);
+        const bool is_deadly = above == HiddenCellType::kStoneFalling || above == HiddenCellType::kDiamondFalling ||
+                               (above == HiddenCellType::kBombFalling && !shared_state_ptr->disable_explosions);
+        if (is_deadly && IsHazardIsolated(index_above, index, agent_index)) {
+            return true;
+        }
+    }
+    // Fireflies and butterflies explode when adjacent to the agent
+    for (const auto dir : {Direction::kUp, Direction::kLeft, Direction::kDown, Direction::kRight}) {
+        if (!InBounds(agent_index, dir)) {
+            continue;
+        }
+        const std::size_t index_creature = IndexFromDirection(agent_index, dir);
+        const Element &element = GetItem(index_creature);
+        if (index_creature != index && (IsFirefly(element) || IsButterfly(element)) &&
+            IsHazardIsolated(index_creature, index, agent_index)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 auto RNDGameState::observation_shape() const noexcept -> std::array<std::size_t, 3> {
     return {kNumVisibleCellType, board.rows, board.cols};
 }
 
+namespace {
+// Per-cell channel IDs fed to the one-hot kernel, reused across calls on the same thread
+auto channel_id_scratch(std::size_t size) -> uint8_t * {
+    thread_local std::vector<uint8_t> scratch;
+    scratch.resize(size);
+    return scratch.data();
+}
+}    // namespace
+
 auto RNDGameState::get_observation() const noexcept -> std::vector<float> {
+    std::vector<float> obs(kNumVisibleCellType * board.cols * board.rows);
+    get_observation(obs.data());
+    return obs;
+}
+
+void RNDGameState::get_observation(std::vector<float> &obs) const noexcept {
+    obs.resize(kNumVisibleCellType * board.cols * board.rows);
+    get_observation(obs.data());
+}
+
+void RNDGameState::get_observation(float *obs) const noexcept {
     const std::size_t channel_length = board.cols * board.rows;
-    std::vector<float> obs(kNumVisibleCellType * channel_length, 0);
+    uint8_t *channels = channel_id_scratch(channel_length);
     for (std::size_t i = 0; i < channel_length; ++i) {
-        obs[static_cast<std::size_t>(GetItem(i).visible_type) * channel_length + i] = 1;
+        channels[i] = static_cast<uint8_t>(GetItem(i).visible_type);
     }
-    return obs;
+    write_one_hot_planes(channels, channel_length, kNumVisibleCellType, obs);
 }
 
-void RNDGameState::get_observation(std::vector<float> &obs) const noexcept {
+void RNDGameState::get_observation(uint8_t *obs) const noexcept {
+    const std::size_t channel_length = board.cols * board.rows;
+    uint8_t *channels = channel_id_scratch(channel_length);
+    for (std::size_t i = 0; i < channel_length; ++i) {
+        channels[i] = static_cast<uint8_t>(GetItem(i).visible_type);
+    }
+    write_one_hot_planes(channels, channel_length, kNumVisibleCellType, obs);
+}
+
+void RNDGameState::get_observation_packed(uint8_t *obs) const noexcept {
     const std::size_t channel_length = board.cols * board.rows;
-    const std::size_t obs_size = kNumVisibleCellType * channel_length;
-    obs.clear();
-    obs.reserve(obs_size);
-    std::fill_n(std::back_inserter(obs), obs_size, static_cast<float>(0));
+    std::fill_n(obs, packed_observation_size(), static_cast<uint8_t>(0));
     for (std::size_t i = 0; i < channel_length; ++i) {
-        obs[static_cast<std::size_t>(GetItem(i).visible_type) * channel_length + i] = 1;
+        const std::size_t bit = static_cast<std::size_t>(GetItem(i).visible_type) * channel_length + i;
+        obs[bit / CHAR_BIT] |= static_cast<uint8_t>(1U << (bit % CHAR_BIT));
     }
 }
 
+auto RNDGameState::packed_observation_size() const noexcept -> std::size_t {
+    return (kNumVisibleCellType * board.cols * board.rows + CHAR_BIT - 1) / CHAR_BIT;
+}
+
 auto RNDGameState::get_observation(const std::vector<VisibleCellType> &filter_elements) const noexcept
     -> std::vector<float> {
+    return get_observation(ObservationSpec(filter_elements));
+}
+
+auto RNDGameState::observation_shape(const ObservationSpec &spec) const noexcept -> std::array<std::size_t, 3> {
+    return {spec.num_channels, board.rows, board.cols};
+}
+
+auto RNDGameState::get_observation(const ObservationSpec &spec) const noexcept -> std::vector<float> {
+    std::vector<float> obs(spec.num_channels * board.cols * board.rows);
+    get_observation(spec, obs.data());
+    return obs;
+}
+
+void RNDGameState::get_observation(const ObservationSpec &spec, std::vector<float> &obs) const noexcept {
+    obs.resize(spec.num_channels * board.cols * board.rows);
+    get_observation(spec, obs.data());
+}
+
+void RNDGameState::get_observation(const ObservationSpec &spec, float *obs) const noexcept {
     const std::size_t channel_length = board.cols * board.rows;
-    std::vector<float> obs(filter_elements.size() * channel_length, 0);
+    uint8_t *channels = channel_id_scratch(channel_length);
     for (std::size_t i = 0; i < channel_length; ++i) {
-        // Slow but this allows us to control the order of the element channels than arbitrary set
-        const auto channel = static_cast<std::size_t>(
-            std::distance(filter_elements.begin(),
-                          std::find(filter_elements.begin(), filter_elements.end(), GetItem(i).visible_type)));
-        obs[channel * channel_length + i] =
-            channel < filter_elements.size() ? static_cast<float>(1) : static_cast<float>(0);
+        channels[i] = spec.channel(GetItem(i).visible_type);
+    }
+    write_one_hot_planes(channels, channel_length, spec.num_channels, obs);
+}
+
+void RNDGameState::update_observation(std::vector<float> &obs) const noexcept {
+    const std::size_t channel_length = board.cols * board.rows;
+    assert(obs.size() == kNumVisibleCellType * channel_length);
+    for (const auto &changed : board.changed_cells) {
+        // Clear the channel of the element before the step, then set the channel of the current element
+        // NOLINTNEXTLINE(*-bounds-constant-array-index)
+        const Element &previous = kCellTypeToElement[static_cast<std::size_t>(changed.previous) + 1];
+        obs[static_cast<std::size_t>(previous.visible_type) * channel_length + changed.index] = 0;
+        obs[static_cast<std::size_t>(GetItem(changed.index).visible_type) * channel_length + changed.index] = 1;
+    }
+}
+
+void RNDGameState::update_observation(const ObservationSpec &spec, std::vector<float> &obs) const noexcept {
+    const std::size_t channel_length = board.cols * board.rows;
+    assert(obs.size() == spec.num_channels * channel_length);
+    for (const auto &changed : board.changed_cells) {
+        // NOLINTNEXTLINE(*-bounds-constant-array-index)
+        const Element &previous = kCellTypeToElement[static_cast<std::size_t>(changed.previous) + 1];
+        const uint8_t previous_channel = spec.channel(previous.visible_type);
+        const uint8_t current_channel = spec.channel(GetItem(changed.index).visible_type);
+        if (previous_channel != ObservationSpec::kNoChannel) {
+            obs[previous_channel * channel_length + changed.index] = 0;
+        }
+        if (current_channel != ObservationSpec::kNoChannel) {
+            obs[current_channel * channel_length + changed.index] = 1;
+        }
+    }
+}
+
+auto RNDGameState::get_changed_indices() const noexcept -> std::vector<std::size_t> {
+    std::vector<std::size_t> indices;
+    get_changed_indices(indices);
+    return indices;
+}
+
+void RNDGameState::get_changed_indices(std::vector<std::size_t> &indices) const noexcept {
+    indices.clear();
+    for (const auto &changed : board.changed_cells) {
+        indices.push_back(changed.index);
     }
+}
+
+auto RNDGameState::cropped_observation_shape(std::size_t window_rows, std::size_t window_cols) const noexcept
+    -> std::array<std::size_t, 3> {
+    return {kNumVisibleCellType, window_rows, window_cols};
+}
+
+auto RNDGameState::get_cropped_observation(std::size_t window_rows, std::size_t window_cols,
+                                           VisibleCellType padding_element) const noexcept -> std::vector<float> {
+    std::vector<float> obs(kNumVisibleCellType * window_rows * window_cols);
+    get_cropped_observation(window_rows, window_cols, obs.data(), padding_element);
     return obs;
 }
 
-// VisibleCellType to image binary data
-#include "assets_all.inc"
+void RNDGameState::get_cropped_observation(std::size_t window_rows, std::size_t window_cols, float *obs,
+                                           VisibleCellType padding_element) const noexcept {
+    const std::size_t channel_length = window_rows * window_cols;
+    uint8_t *channels = channel_id_scratch(channel_length);
+    get_cropped_observation_ids(window_rows, window_cols, reinterpret_cast<int8_t *>(channels), padding_element);
+    write_one_hot_planes(channels, channel_length, kNumVisibleCellType, obs);
+}
+
+auto RNDGameState::get_cropped_observation_ids(std::size_t window_rows, std::size_t window_cols,
+                                               VisibleCellType padding_element) const noexcept -> std::vector<int8_t> {
+    std::vector<int8_t> ids(window_rows * window_cols);
+    get_cropped_observation_ids(window_rows, window_cols, ids.data(), padding_element);
+    return ids;
+}
+
+void RNDGameState::get_cropped_observation_ids(std::size_t window_rows, std::size_t window_cols, int8_t *ids,
+                                               VisibleCellType padding_element) const noexcept {
+    // Window top left in board coordinates, can be negative when the agent is near the top/left edge
+    const auto [agent_row, agent_col] = index_to_position(board.agent_idx);
+    const auto top = static_cast<std::ptrdiff_t>(agent_row) - static_cast<std::ptrdiff_t>(window_rows / 2);
+    const auto left = static_cast<std::ptrdiff_t>(agent_col) - static_cast<std::ptrdiff_t>(window_cols / 2);
+    const auto rows = static_cast<std::ptrdiff_t>(board.rows);
+    const auto cols = static_cast<std::ptrdiff_t>(board.cols);
+    // Columns of the window which overlap the board
+    const std::ptrdiff_t col_begin = std::clamp<std::ptrdiff_t>(-left, 0, static_cast<std::ptrdiff_t>(window_cols));
+    const std::ptrdiff_t col_end = std::clamp<std::ptrdiff_t>(cols - left, col_begin,
+                                                              static_cast<std::ptrdiff_t>(window_cols));
+    const auto padding = to_underlying(padding_element);
+    for (std::size_t r = 0; r < window_rows; ++r) {
+        int8_t *window_row = ids + r * window_cols;
+        const std::ptrdiff_t board_row = top + static_cast<std::ptrdiff_t>(r);
+        if (board_row < 0 || board_row >= rows) {
+            std::fill_n(window_row, window_cols, padding);
+            continue;
+        }
+        std::fill_n(window_row, col_begin, padding);
+        for (std::ptrdiff_t c = col_begin; c < col_end; ++c) {
+            window_row[c] = to_underlying(GetItem(static_cast<std::size_t>(board_row * cols + left + c)).visible_type);
+        }
+        std::fill(window_row + col_end, window_row + window_cols, padding);
+    }
+}
+
+namespace {
+void check_tile_size(std::size_t tile_size) {
+    if (!is_valid_tile_size(tile_size)) {
+        throw std::invalid_argument(std::string("Unsupported tile size: ") + std::to_string(tile_size));
+    }
+}
+}    // namespace
 
 auto RNDGameState::image_shape() const noexcept -> std::array<std::size_t, 3> {
     const auto rows = board.rows;
@@ -310,26 +846,49 @@ auto RNDGameState::image_shape() const noexcept -> std::array<std::size_t, 3> {
     return {rows * SPRITE_HEIGHT, cols * SPRITE_WIDTH, SPRITE_CHANNELS};
 }
 
+auto RNDGameState::image_shape(std::size_t tile_size) const -> std::array<std::size_t, 3> {
+    check_tile_size(tile_size);
+    return {board.rows * tile_size, board.cols * tile_size, SPRITE_CHANNELS};
+}
+
 auto RNDGameState::to_image() const noexcept -> std::vector<uint8_t> {
-    const std::size_t flat_size = board.cols * board.rows;
-    std::vector<uint8_t> img(flat_size * SPRITE_DATA_LEN, 0);
+    std::vector<uint8_t> img;
+    to_image(img);
+    return img;
+}
+
+void RNDGameState::to_image(std::vector<uint8_t> &img) const noexcept {
+    img.resize(board.cols * board.rows * SPRITE_DATA_LEN);
+    DrawTiles(img.data(), SPRITE_WIDTH);
+}
+
+void RNDGameState::to_image(uint8_t *img) const noexcept {
+    DrawTiles(img, SPRITE_WIDTH);
+}
+
+auto RNDGameState::to_image(std::size_t tile_size) const -> std::vector<uint8_t> {
+    std::vector<uint8_t> img;
+    to_image(img, tile_size);
+    return img;
+}
+
+void RNDGameState::to_image(std::vector<uint8_t> &img, std::size_t tile_size) const {
+    check_tile_size(tile_size);
+    img.resize(board.cols * board.rows * tile_size * tile_size * SPRITE_CHANNELS);
+    DrawTiles(img.data(), tile_size);
+}
+
+void RNDGameState::to_image(uint8_t *img, std::size_t tile_size) const {
+    check_tile_size(tile_size);
+    DrawTiles(img, tile_size);
+}
+
+void RNDGameState::DrawTiles(uint8_t *img, std::size_t tile_size) const noexcept {
     for (std::size_t h = 0; h < board.rows; ++h) {
         for (std::size_t w = 0; w < board.cols; ++w) {
-            const std::size_t img_idx_top_left = h * (SPRITE_DATA_LEN * board.cols) + (w * SPRITE_DATA_LEN_PER_ROW);
-            const std::vector<uint8_t> &data = img_asset_map.at(GetItem(h * board.cols + w).visible_type);
-            for (std::size_t r = 0; r < SPRITE_HEIGHT; ++r) {
-                for (std::size_t c = 0; c < SPRITE_WIDTH; ++c) {
-                    const std::size_t data_idx = (r * SPRITE_DATA_LEN_PER_ROW) + (3 * c);
-                    const std::size_t img_idx =
-                        (r * SPRITE_DATA_LEN_PER_ROW * board.cols) + (SPRITE_CHANNELS * c) + img_idx_top_left;
-                    img[img_idx + 0] = data[data_idx + 0];
-                    img[img_idx + 1] = data[data_idx + 1];
-                    img[img_idx + 2] = data[data_idx + 2];
-                }
-            }
+            draw_sprite(img, board.cols, h, w, GetItem(h * board.cols + w).visible_type, tile_size);
         }
     }
-    return img;
 }
 
 auto RNDGameState::board_to_str() const noexcept -> std::string {
@@ -354,10 +913,24 @@ auto RNDGameState::get_reward_signal() const noexcept -> uint64_t {
     return local_state.reward_signal;
 }
 
+auto RNDGameState::get_current_reward() const noexcept -> int {
+    return local_state.current_reward;
+}
+
+auto RNDGameState::get_steps_remaining() const noexcept -> int {
+    return board.max_steps > 0 ? local_state.steps_remaining : -1;
+}
+
 auto RNDGameState::get_hash() const noexcept -> uint64_t {
     return board.zorb_hash;
 }
 
+auto RNDGameState::memory_bytes() const noexcept -> std::size_t {
+    return sizeof(RNDGameState) + board.grid.capacity() * sizeof(HiddenCellType) + board.has_updated.capacity() +
+           board.has_changed.capacity() + board.changed_cells.capacity() * sizeof(ChangedCell) +
+           local_state.index_id_mappings.capacity() * sizeof(IndexId);
+}
+
 auto RNDGameState::get_positions(HiddenCellType element) const noexcept -> std::vector<Position> {
     assert(is_valid_hidden_element(element));
     std::vector<Position> indices;
@@ -430,6 +1003,16 @@ auto RNDGameState::get_hidden_item(std::size_t index) const noexcept -> HiddenCe
     return board.item(index);
 }
 
+auto RNDGameState::get_visible_item(std::size_t index) const noexcept -> VisibleCellType {
+    assert(index < board.rows * board.cols);
+    return GetItem(index).visible_type;
+}
+
+void RNDGameState::get_distance_map(const std::vector<HiddenCellType> &targets, DistanceMap &map) const noexcept {
+    map.SetTerrain(*this, targets);
+    map.Search();
+}
+
 auto operator<<(std::ostream &os, const RNDGameState &state) -> std::ostream & {
     const auto print_horz_boarder = [&]() {
         for (std::size_t w = 0; w < state.board.cols + 2; ++w) {
@@ -536,7 +1119,7 @@ void RNDGameState::UpdateIndexID(std::size_t index) noexcept {
 }
 
 void RNDGameState::AddIndexID(std::size_t index) noexcept {
-    switch (board.item(index)) {
+    switch (cells.item(index)) {
         case HiddenCellType::kStone:
         case HiddenCellType::kStoneFalling:
         case HiddenCellType::kDiamond:
@@ -561,19 +1144,21 @@ void RNDGameState::RemoveIndexID(std::size_t index) noexcept {
 
 void RNDGameState::MoveItem(std::size_t index, Direction direction) noexcept {
     const std::size_t new_index = IndexFromDirection(index, direction);
+    cells.mark_changed(new_index);
+    cells.mark_changed(index);
     board.zorb_hash ^= shared_state_ptr->zrbht.at(
-        (static_cast<std::size_t>(board.item(new_index)) * board.cols * board.rows) + new_index);
-    board.item(new_index) = board.item(index);
+        (static_cast<std::size_t>(cells.item(new_index)) * board.cols * board.rows) + new_index);
+    cells.item(new_index) = cells.item(index);
     board.zorb_hash ^= shared_state_ptr->zrbht.at(
-        (static_cast<std::size_t>(board.item(new_index)) * board.cols * board.rows) + new_index);
+        (static_cast<std::size_t>(cells.item(new_index)) * board.cols * board.rows) + new_index);
     // grid_.ids[new_index] = grid_.ids[index];
 
     board.zorb_hash ^=
-        shared_state_ptr->zrbht.at((static_cast<std::size_t>(board.item(index)) * board.cols * board.rows) + index);
-    board.item(index) = kElEmpty.cell_type;
+        shared_state_ptr->zrbht.at((static_cast<std::size_t>(cells.item(index)) * board.cols * board.rows) + index);
+    cells.item(index) = kElEmpty.cell_type;
     board.zorb_hash ^= shared_state_ptr->zrbht.at(
         (static_cast<std::size_t>(ElementToItem(kElEmpty)) * board.cols * board.rows) + index);
-    board.has_updated[new_index] = true;
+    cells.updated(new_index) = true;
     // grid_.ids[index] = ++id_counter_;
 
     // Update ID
@@ -583,19 +1168,20 @@ void RNDGameState::MoveItem(std::size_t index, Direction direction) noexcept {
 void RNDGameState::SetItem(std::size_t index, const Element &element, int id, Direction direction) noexcept {
     (void)id;
     const std::size_t new_index = IndexFromDirection(index, direction);
+    cells.mark_changed(new_index);
     board.zorb_hash ^= shared_state_ptr->zrbht.at(
-        (static_cast<std::size_t>(board.item(new_index)) * board.cols * board.rows) + new_index);
-    board.item(new_index) = element.cell_type;
+        (static_cast<std::size_t>(cells.item(new_index)) * board.cols * board.rows) + new_index);
+    cells.item(new_index) = element.cell_type;
     board.zorb_hash ^= shared_state_ptr->zrbht.at(
         (static_cast<std::size_t>(ElementToItem(element)) * board.cols * board.rows) + new_index);
     // grid_.ids[new_index] = id;
-    board.has_updated[new_index] = true;
+    cells.updated(new_index) = true;
 }
 
 auto RNDGameState::GetItem(std::size_t index, Direction direction) const noexcept -> const Element & {
     const std::size_t new_index = IndexFromDirection(index, direction);
     // NOLINTNEXTLINE(*-bounds-constant-array-index)
-    return kCellTypeToElement[static_cast<std::size_t>(board.item(new_index)) + 1];
+    return kCellTypeToElement[static_cast<std::size_t>(cells.item(new_index)) + 1];
 }
 
 auto RNDGameState::IsTypeAdjacent(std::size_t index, const Element &element) const noexcept -> bool {
@@ -1038,8 +1624,8 @@ void RNDGameState::UpdateExplosions(std::size_t index) noexcept {
 }
 
 void RNDGameState::OpenGate(const Element &element) noexcept {
-    for (std::size_t index = 0; index < board.grid.size(); ++index) {
-        if (board.item(index) == element.cell_type) {
+    for (std::size_t index = 0; index < board.rows * board.cols; ++index) {
+        if (cells.item(index) == element.cell_type) {
             SetItem(index, kGateOpenMap.at(GetItem(index)), -1);
         }
     }
@@ -1047,6 +1633,58 @@ void RNDGameState::OpenGate(const Element &element) noexcept {
 
 // ---------------------------------------------------------------------------
 
+void RNDGameState::UpdateCell(std::size_t index) noexcept {
+    switch (cells.item(index)) {
+        // Handle non-compound types
+        case HiddenCellType::kStone:
+            UpdateStone(index);
+            break;
+        case HiddenCellType::kStoneFalling:
+            UpdateStoneFalling(index);
+            break;
+        case HiddenCellType::kDiamond:
+            UpdateDiamond(index);
+            break;
+        case HiddenCellType::kDiamondFalling:
+            UpdateDiamondFalling(index);
+            break;
+        case HiddenCellType::kNut:
+            UpdateNut(index);
+            break;
+        case HiddenCellType::kNutFalling:
+            UpdateNutFalling(index);
+            break;
+        case HiddenCellType::kBomb:
+            UpdateBomb(index);
+            break;
+        case HiddenCellType::kBombFalling:
+            UpdateBombFalling(index);
+            break;
+        case HiddenCellType::kExitClosed:
+            UpdateExit(index);
+            break;
+        case HiddenCellType::kBlob:
+            UpdateBlob(index);
+            break;
+        default:
+            // Handle compound types
+            // NOLINTNEXTLINE(*-bounds-constant-array-index)
+            const Element &element = kCellTypeToElement[static_cast<std::size_t>(cells.item(index)) + 1];
+            if (IsButterfly(element)) {
+                UpdateButterfly(index, kButterflyToDirection.at(element));
+            } else if (IsFirefly(element)) {
+                UpdateFirefly(index, kFireflyToDirection.at(element));
+            } else if (IsOrange(element)) {
+                UpdateOrange(index, kOrangeToDirection.at(element));
+            } else if (IsMagicWall(element)) {
+                UpdateMagicWall(index);
+            } else if (IsExplosion(element)) {
+                UpdateExplosions(index);
+            }
+            break;
+    }
+}
+
 void RNDGameState::StartScan() noexcept {
     if (local_state.steps_remaining > 0) {
         local_state.steps_remaining += -1;
@@ -1055,7 +1693,7 @@ void RNDGameState::StartScan() noexcept {
     local_state.blob_size = 0;
     local_state.blob_enclosed = true;
     local_state.reward_signal = 0;
-    board.reset_updated();
+    cells.reset_changed();
 }
 
 void RNDGameState::EndScan() noexcept {
@@ -1074,4 +1712,156 @@ void RNDGameState::EndScan() noexcept {
     local_state.magic_active = local_state.magic_active && (local_state.magic_wall_steps > 0);
 }
 
+// Cells whose update reads the given cell are within one row and column of it, the cells two away only matter to
+// falling elements over a magic wall, which are tracked. Adds those after the given index.
+void RNDGameState::AddNeighbourhood(std::size_t index, std::size_t after, std::vector<std::size_t> &cells) const
+    noexcept {
+    const std::size_t row = index / board.cols;
+    const std::size_t col = index % board.cols;
+    const std::size_t row_end = std::min(row + 1, board.rows - 1);
+    const std::size_t col_end = std::min(col + 1, board.cols - 1);
+    for (std::size_t r = (row > 0) ? row - 1 : 0; r <= row_end; ++r) {
+        for (std::size_t c = (col > 0) ? col - 1 : 0; c <= col_end; ++c) {
+            if (r * board.cols + c >= after) {
+                cells.push_back(r * board.cols + c);
+            }
+        }
+    }
+}
+
+// apply_action(kNoop) which only scans the seed cells, and the cells next to writes made during the scan which come
+// later in scan order. Cells are visited in index order like the full scan, so the result is the same whenever every
+// other cell would do nothing.
+void RNDGameState::ApplyNoopActive(const std::vector<std::size_t> &seeds) noexcept {
+    thread_local std::vector<std::size_t> heap;
+    thread_local std::vector<std::size_t> added;
+    thread_local std::vector<std::size_t> queued;
+    thread_local std::vector<uint8_t> is_queued;
+    is_queued.resize(board.rows * board.cols, 0);
+    heap.clear();
+    queued.clear();
+    const auto push = [&](const std::vector<std::size_t> &cells) {
+        for (const auto index : cells) {
+            if (!is_queued[index]) {
+                is_queued[index] = 1;
+                queued.push_back(index);
+                heap.push_back(index);
+                std::push_heap(heap.begin(), heap.end(), std::greater<>());
+            }
+        }
+    };
+    push(seeds);
+
+    StartScan();
+    UpdateAgent(board.agent_idx, Direction::kNoop);
+    std::size_t num_seen = 0;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+        const std::size_t index = heap.back();
+        heap.pop_back();
+        if (!cells.updated(index)) {
+            UpdateCell(index);
+        }
+        added.clear();
+        for (; num_seen < board.changed_cells.size(); ++num_seen) {
+            AddNeighbourhood(board.changed_cells[num_seen].index, index + 1, added);
+        }
+        push(added);
+    }
+    EndScan();
+
+    for (const auto index : queued) {
+        is_queued[index] = 0;
+    }
+}
+
+
+// ---------------------------------------------------------------------------
+
+// Mirrors the branches of UpdateAgent, true if moving in the direction writes no cells so the step matches kNoop
+auto RNDGameState::IsAgentBlocked(Direction direction) const noexcept -> bool {
+    const std::size_t index = board.agent_idx;
+    if (!InBounds(index, direction)) {
+        return true;
+    }
+    const Element &element = GetItem(index, direction);
+    if (element == kElEmpty || element == kElDirt || element == kElDiamond || element == kElDiamondFalling ||
+        IsKey(element) || element == kElExitOpen) {
+        return false;
+    }
+    const std::size_t new_index = IndexFromDirection(index, direction);
+    if (IsDirectionHorz(direction) && (element.properties & ElementProperties::kPushable) > 0) {
+        return !IsType(new_index, kElEmpty, direction);
+    }
+    if (IsOpenGate(element)) {
+        return !HasProperty(new_index, ElementProperties::kTraversable, direction);
+    }
+    return true;
+}
+
+// True if the agent walks onto empty or dirt and no element which updates during the scan is within two cells of
+// either end. Scan updates read and write at most two cells away from the updating element (falling through a magic
+// wall), so the rest of the tick cannot observe the move and matches the kNoop child.
+auto RNDGameState::IsAgentMoveIsolated(Direction direction) const noexcept -> bool {
+    constexpr std::size_t kRadius = 2;
+    const std::size_t index = board.agent_idx;
+    if (board.agent_pos != index || board.item(index) != HiddenCellType::kAgent || !InBounds(index, direction) ||
+        !(IsType(index, kElEmpty, direction) || IsType(index, kElDirt, direction))) {
+        return false;
+    }
+    const std::size_t new_index = IndexFromDirection(index, direction);
+    const std::size_t row_min = std::min(index, new_index) / board.cols;
+    const std::size_t row_max = std::max(index, new_index) / board.cols;
+    const std::size_t col_min = std::min(index % board.cols, new_index % board.cols);
+    const std::size_t col_max = std::max(index % board.cols, new_index % board.cols);
+    const std::size_t row_end = std::min(row_max + kRadius, board.rows - 1);
+    const std::size_t col_end = std::min(col_max + kRadius, board.cols - 1);
+    for (std::size_t r = (row_min > kRadius) ? row_min - kRadius : 0; r <= row_end; ++r) {
+        for (std::size_t c = (col_min > kRadius) ? col_min - kRadius : 0; c <= col_end; ++c) {
+            if (IsScanActive(board.item(r * board.cols + c))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// True if nothing can remove the hazard before it acts. Elements scanned before the hazard can write up to two cells
+// away, and explosions chain through explodable elements next to it regardless of scan order. The agent's start and end
+// cells are skipped as they hold empty and the agent after its move.
+auto RNDGameState::IsHazardIsolated(std::size_t index, std::size_t index_from, std::size_t index_to) const noexcept
+    -> bool {
+    constexpr std::size_t kRadius = 2;
+    const std::size_t row = index / board.cols;
+    const std::size_t col = index % board.cols;
+    const std::size_t row_end = std::min(row + kRadius, board.rows - 1);
+    const std::size_t col_end = std::min(col + kRadius, board.cols - 1);
+    for (std::size_t r = (row > kRadius) ? row - kRadius : 0; r <= row_end; ++r) {
+        for (std::size_t c = (col > kRadius) ? col - kRadius : 0; c <= col_end; ++c) {
+            const std::size_t i = r * board.cols + c;
+            if (i == index || i == index_from || i == index_to) {
+                continue;
+            }
+            const bool is_adjacent = (r + 1 >= row && r <= row + 1 && c + 1 >= col && c <= col + 1);
+            if ((i < index && IsScanActive(board.item(i))) ||
+                (is_adjacent && HasProperty(i, ElementProperties::kCanExplode))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Set this state to the child of an isolated move, by replaying the agent move on top of the kNoop child
+void RNDGameState::ApplyIsolatedMove(const RNDGameState &noop_child, Direction direction) noexcept {
+    *this = noop_child;
+    const std::size_t index = board.agent_idx;
+    MoveItem(index, direction);
+    board.agent_pos = IndexFromDirection(index, direction);
+    board.agent_idx = IndexFromDirection(index, direction);
+    // The agent moves before the scan, so its cells are the first to be marked as changed
+    auto &changed_cells = board.changed_cells;
+    std::rotate(changed_cells.begin(), changed_cells.end() - 2, changed_cells.end());
+}
+
 }    // namespace stonesngems
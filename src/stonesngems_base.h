@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -16,14 +17,12 @@
 #include <vector>
 
 #include "definitions.h"
+#include "sprite_atlas.h"
 
 namespace stonesngems {
 
-constexpr int SPRITE_WIDTH = 32;
-constexpr int SPRITE_HEIGHT = 32;
-constexpr int SPRITE_CHANNELS = 3;
-constexpr int SPRITE_DATA_LEN_PER_ROW = SPRITE_WIDTH * SPRITE_CHANNELS;
-constexpr int SPRITE_DATA_LEN = SPRITE_WIDTH * SPRITE_HEIGHT * SPRITE_CHANNELS;
+struct ChildInfo;
+class DistanceMap;
 
 // Game parameter can be boolean, integral or floating point
 using GameParameter = std::variant<bool, int, float, std::string>;
@@ -150,6 +149,52 @@ struct LocalState {
                   current_reward, magic_wall_steps, blob_size, id_state, blob_swap, magic_active, blob_enclosed);
 };
 
+// Precomputed mapping from visible elements to observation channels, used for filtered observations
+struct ObservationSpec {
+    static constexpr uint8_t kNoChannel = std::numeric_limits<uint8_t>::max();
+
+    ObservationSpec() = default;
+
+    /**
+     * Build the channel lookup table.
+     * @param filter_elements Elements to observe, in channel order (duplicates map to their first channel)
+     */
+    ObservationSpec(const std::vector<VisibleCellType> &filter_elements);
+
+    /**
+     * Get the channel the given element is observed in.
+     * @param element The visible element to query
+     * @return The channel, or kNoChannel if the element is not observed
+     */
+    [[nodiscard]] auto channel(VisibleCellType element) const noexcept -> uint8_t {
+        const auto element_idx = static_cast<uint8_t>(element);
+        // NOLINTNEXTLINE(*-bounds-constant-array-index)
+        return element_idx < kNumVisibleCellType ? channel_map[element_idx] : kNoChannel;
+    }
+
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    std::array<uint8_t, kNumVisibleCellType> channel_map{};    // VisibleCellType to channel, or kNoChannel
+    std::size_t num_channels = 0;                              // Number of channels in the observation
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+// Outcome of a macro move made with RNDGameState::apply_path_to()
+struct PathResult {
+    std::size_t ticks = 0;         // Number of calls to apply_action() made
+    uint64_t reward_signal = 0;    // Events of all ticks, the union of their reward signals
+    int reward = 0;                // Sum of the rewards of all ticks
+    bool reached = false;          // Flag if the agent ended on the target cell
+};
+
+// Outcome of running kNoop ticks with RNDGameState::advance_until_stable()
+struct StableResult {
+    std::size_t ticks = 0;         // Number of calls to apply_action() made
+    uint64_t reward_signal = 0;    // Events of all ticks, the union of their reward signals
+    int reward = 0;                // Sum of the rewards of all ticks
+    bool stable = false;           // Flag if no falling element or explosion is left on the board
+    bool perpetual = false;        // Flag if creatures or blobs are left, which keep changing the board every tick
+};
+
 // Game state
 class RNDGameState {
 public:
@@ -159,10 +204,18 @@ public:
 
     /**
      * Construct from byte serialization.
-     * @note this is not safe, only for internal use.
+     * @note this is not safe, only for internal use. The changed cells of the last step are not serialized, so take a
+     * full observation with get_observation() before using update_observation().
      */
     RNDGameState(const std::vector<uint8_t> &byte_data);
 
+    // Copies and moves point the rules at the board of the new state
+    RNDGameState(const RNDGameState &other);
+    RNDGameState(RNDGameState &&other) noexcept;
+    auto operator=(const RNDGameState &other) -> RNDGameState &;
+    auto operator=(RNDGameState &&other) noexcept -> RNDGameState &;
+    ~RNDGameState() = default;
+
     auto operator==(const RNDGameState &other) const noexcept -> bool;
     auto operator!=(const RNDGameState &other) const noexcept -> bool;
 
@@ -177,6 +230,21 @@ public:
      */
     [[nodiscard]] auto serialize() const -> std::vector<uint8_t>;
 
+    /**
+     * Serialize only the parts of the state which change between steps, without the shared game parameters.
+     * @return char vector representing the board and local state
+     */
+    [[nodiscard]] auto serialize_local() const -> std::vector<uint8_t>;
+
+    /**
+     * Load the board and local state from serialize_local(), keeping the shared game parameters of this state.
+     * @note this is not safe, byte_data must come from a state of the same level and game parameters. The changed cells
+     * of the last step are cleared, so take a full observation with get_observation() before using
+     * update_observation().
+     * @param byte_data Bytes from serialize_local()
+     */
+    void deserialize_local(const std::vector<uint8_t> &byte_data);
+
     /**
      * Check if the given visible element is valid.
      * @param element Element to check
@@ -210,6 +278,29 @@ public:
      */
     void apply_action(Action action);
 
+    /**
+     * Walk the agent to the target cell as a single macro move. A shortest safe path is planned with BFS, through empty
+     * cells and dirt which are not below a stone, diamond, nut or bomb and not next to a creature, and its actions are
+     * applied with apply_action(). The walk stops early before a fatal action, or after a tick which emits a reward
+     * signal, kills the agent, leaves the agent off the path, or changes cells around the rest of the path.
+     * @note No action is applied if there is no safe path or the agent already is on the target
+     * @param target_index The flat index of the cell to walk to, which may also hold a diamond, key or open exit
+     * @return The number of ticks applied, the events and reward collected, and whether the target was reached
+     */
+    auto apply_path_to(std::size_t target_index) -> PathResult;
+
+    /**
+     * Apply kNoop until nothing is falling or exploding, such as after a push or an explosion. After one full tick,
+     * each tick only scans the active cells: the falling, exploding, creature and blob cells, and the cells next to
+     * the writes of the last tick and of the tick so far. Quiet cells are skipped, while the result matches calling
+     * apply_action(kNoop) for each tick. Stops early if the agent dies, the level times out, or a tick changes nothing
+     * while falling elements are left (they are stuck, for example on a spent magic wall).
+     * @param max_ticks Maximum number of ticks to apply
+     * @return The number of ticks applied, the events and reward collected, whether the board settled, and whether
+     * creatures or blobs keep the board from ever being quiet
+     */
+    auto advance_until_stable(std::size_t max_ticks) -> StableResult;
+
     /**
      * Check if the state is terminal, meaning either solution, timeout, or agent dies.
      * @return True if terminal, false otherwise
@@ -222,18 +313,42 @@ public:
      */
     [[nodiscard]] auto is_solution() const noexcept -> bool;
 
+    /**
+     * Check if the state can never reach a solution, so search can cut its subtree. The check is sound but incomplete:
+     * it never reports a solvable state, and misses many dead ends. A state is unsolvable if it is terminal without
+     * being a solution, if the diamonds left on the board and obtainable from nuts, butterflies, magic walls and blobs
+     * cannot make up the gems still required, or if no exit is reachable in the remaining steps through cells which are
+     * not steel walls.
+     * @note Costs about two scans of the board, less than a call to apply_action()
+     * @return True if no sequence of actions leads to a solution, false if the state may still be solvable
+     */
+    [[nodiscard]] auto is_provably_unsolvable() const noexcept -> bool;
+
     /**
      * Get the legal actions which can be applied in the state.
+     * @param pruned Remove actions which are blocked by the agent's neighbourhood (walls, closed gates, stones which
+     * cannot be pushed), as their successor is identical to kNoop. kNoop is always kept.
      * @return vector containing each actions available
      */
-    [[nodiscard]] auto legal_actions() const noexcept -> std::vector<Action>;
+    [[nodiscard]] auto legal_actions(bool pruned = false) const noexcept -> std::vector<Action>;
 
     /**
      * Get the legal actions which can be applied in the state, and store in the given vector.
      * @note Use when wanting to reuse a pre-allocated vector
      * @param actions The vector to store the available actions in
+     * @param pruned Remove actions whose successor is identical to kNoop, see legal_actions(bool)
      */
-    void legal_actions(std::vector<Action> &actions) const noexcept;
+    void legal_actions(std::vector<Action> &actions, bool pruned = false) const noexcept;
+
+    /**
+     * Check if applying the action is guaranteed to kill the agent on the next step, without simulating it.
+     * Detects a falling stone, diamond, or bomb directly above the cell the agent ends in, and a firefly or butterfly
+     * adjacent to it. The check is conservative: it is only true if no other updating element is close enough to
+     * change the outcome, so false does not imply the action is safe.
+     * @param action The action to check
+     * @return True if the agent is certain to die, false otherwise
+     */
+    [[nodiscard]] auto is_action_fatal(Action action) const noexcept -> bool;
 
     /**
      * Get the number of possible actions
@@ -266,13 +381,166 @@ public:
     void get_observation(std::vector<float> &obs) const noexcept;
 
     /**
-     * Get a flat representation of the current state observation.
-     * The observation should be viewed as the shape given by observation_shape().
+     * Write a flat representation of the current state observation into the given buffer.
+     * The observation should be viewed as the shape given by observation_shape(), where 1 represents the element at the
+     * given position.
+     * @note The buffer must hold at least C * H * W elements, as given by observation_shape()
+     * @param obs Pointer to the start of the buffer
+     */
+    void get_observation(float *obs) const noexcept;
+
+    /**
+     * Write a flat representation of the current state observation into the given byte buffer.
+     * @note The buffer must hold at least C * H * W elements, as given by observation_shape()
+     * @param obs Pointer to the start of the buffer
+     */
+    void get_observation(uint8_t *obs) const noexcept;
+
+    /**
+     * Write a bit-packed flat representation of the current state observation into the given buffer.
+     * Bit i of the flat observation is stored in byte i / 8, at bit position i % 8 (least significant bit first).
+     * @note The buffer must hold at least packed_observation_size() bytes
+     * @param obs Pointer to the start of the buffer
+     */
+    void get_observation_packed(uint8_t *obs) const noexcept;
+
+    /**
+     * Get the number of bytes a bit-packed observation requires.
+     * @return Number of bytes
+     */
+    [[nodiscard]] auto packed_observation_size() const noexcept -> std::size_t;
+
+    /**
+     * Get a flat representation of the current state observation, only containing the given elements.
+     * The observation should be viewed as the shape given by observation_shape(ObservationSpec(filter_elements)).
+     * @note Builds the channel lookup table on each call, use an ObservationSpec when observing repeatedly
+     * @param filter_elements Elements to observe, in channel order
      * @return vector where 1 represents object at position
      */
     [[nodiscard]] auto get_observation(const std::vector<VisibleCellType> &filter_elements) const noexcept
         -> std::vector<float>;
 
+    /**
+     * Get the shape the filtered observations should be viewed as.
+     * @param spec The observation spec holding the observed elements
+     * @return array indicating observation CHW
+     */
+    [[nodiscard]] auto observation_shape(const ObservationSpec &spec) const noexcept -> std::array<std::size_t, 3>;
+
+    /**
+     * Get a flat representation of the current state observation, only containing the elements of the spec.
+     * The observation should be viewed as the shape given by observation_shape(spec).
+     * @param spec The observation spec holding the observed elements
+     * @return vector where 1 represents object at position
+     */
+    [[nodiscard]] auto get_observation(const ObservationSpec &spec) const noexcept -> std::vector<float>;
+
+    /**
+     * Get a flat representation of the current state observation only containing the elements of the spec, and store
+     * in the given vector.
+     * @note Use when wanting to reuse a pre-allocated vector
+     * @param spec The observation spec holding the observed elements
+     * @param obs Vector to store the observation in
+     */
+    void get_observation(const ObservationSpec &spec, std::vector<float> &obs) const noexcept;
+
+    /**
+     * Write a flat representation of the current state observation only containing the elements of the spec into the
+     * given buffer.
+     * @note The buffer must hold at least C * H * W elements, as given by observation_shape(spec)
+     * @param spec The observation spec holding the observed elements
+     * @param obs Pointer to the start of the buffer
+     */
+    void get_observation(const ObservationSpec &spec, float *obs) const noexcept;
+
+    /**
+     * Update the observation of the previous step in place, only touching the cells which changed during the last
+     * step.
+     * @note obs must hold the full observation of the state before the last call to apply_action(), otherwise the
+     * result is undefined. After reset() or deserializing, a full observation should be taken using get_observation().
+     * @param obs Vector holding the observation of the previous step
+     */
+    void update_observation(std::vector<float> &obs) const noexcept;
+
+    /**
+     * Update the filtered observation of the previous step in place, only touching the cells which changed during the
+     * last step.
+     * @note obs must hold the full observation of the state before the last call to apply_action() for the same spec
+     * @param spec The observation spec holding the observed elements
+     * @param obs Vector holding the observation of the previous step
+     */
+    void update_observation(const ObservationSpec &spec, std::vector<float> &obs) const noexcept;
+
+    /**
+     * Get the flat indices of the cells which were written to during the last step.
+     * @note A cell can be written to and still hold the same element as before the step
+     * @return flat indices in the order they were first written to
+     */
+    [[nodiscard]] auto get_changed_indices() const noexcept -> std::vector<std::size_t>;
+
+    /**
+     * Get the flat indices of the cells which were written to during the last step, and store in the given vector.
+     * @note Use when wanting to reuse a pre-allocated vector
+     * @param indices The vector to store the changed indices in
+     */
+    void get_changed_indices(std::vector<std::size_t> &indices) const noexcept;
+
+    /**
+     * Get the shape the agent centred observations should be viewed as.
+     * @param window_rows Number of rows in the window around the agent
+     * @param window_cols Number of columns in the window around the agent
+     * @return array indicating observation CHW
+     */
+    [[nodiscard]] auto cropped_observation_shape(std::size_t window_rows, std::size_t window_cols) const noexcept
+        -> std::array<std::size_t, 3>;
+
+    /**
+     * Get a flat representation of the observation in a fixed size window centred on the agent.
+     * The observation should be viewed as the shape given by cropped_observation_shape().
+     * Window cells outside the board are observed as the padding element.
+     * @param window_rows Number of rows in the window around the agent
+     * @param window_cols Number of columns in the window around the agent
+     * @param padding_element Element to observe outside the board, kNull leaves the cells empty in all channels
+     * @return vector where 1 represents object at position
+     */
+    [[nodiscard]] auto get_cropped_observation(std::size_t window_rows, std::size_t window_cols,
+                                               VisibleCellType padding_element = VisibleCellType::kWallSteel) const
+        noexcept -> std::vector<float>;
+
+    /**
+     * Write a flat representation of the observation in a fixed size window centred on the agent into the given
+     * buffer.
+     * @note The buffer must hold at least C * H * W elements, as given by cropped_observation_shape()
+     * @param window_rows Number of rows in the window around the agent
+     * @param window_cols Number of columns in the window around the agent
+     * @param obs Pointer to the start of the buffer
+     * @param padding_element Element to observe outside the board, kNull leaves the cells empty in all channels
+     */
+    void get_cropped_observation(std::size_t window_rows, std::size_t window_cols, float *obs,
+                                 VisibleCellType padding_element = VisibleCellType::kWallSteel) const noexcept;
+
+    /**
+     * Get the visible element IDs in a fixed size window centred on the agent, as a flat HW vector.
+     * @param window_rows Number of rows in the window around the agent
+     * @param window_cols Number of columns in the window around the agent
+     * @param padding_element Element to report outside the board
+     * @return vector of VisibleCellType IDs
+     */
+    [[nodiscard]] auto get_cropped_observation_ids(std::size_t window_rows, std::size_t window_cols,
+                                                   VisibleCellType padding_element = VisibleCellType::kWallSteel) const
+        noexcept -> std::vector<int8_t>;
+
+    /**
+     * Write the visible element IDs in a fixed size window centred on the agent into the given buffer.
+     * @note The buffer must hold at least window_rows * window_cols elements
+     * @param window_rows Number of rows in the window around the agent
+     * @param window_cols Number of columns in the window around the agent
+     * @param ids Pointer to the start of the buffer
+     * @param padding_element Element to report outside the board
+     */
+    void get_cropped_observation_ids(std::size_t window_rows, std::size_t window_cols, int8_t *ids,
+                                     VisibleCellType padding_element = VisibleCellType::kWallSteel) const noexcept;
+
     /**
      * Get the index corresponding to the given position
      * @return the flat index
@@ -297,6 +565,52 @@ public:
      */
     [[nodiscard]] auto to_image() const noexcept -> std::vector<uint8_t>;
 
+    /**
+     * Write the flat (HWC) image representation of the current state into the given vector, resizing if needed
+     * @param img Vector to write the RGB values into
+     */
+    void to_image(std::vector<uint8_t> &img) const noexcept;
+
+    /**
+     * Write the flat (HWC) image representation of the current state into the given buffer
+     * @param img Pointer to a buffer of at least rows * cols * SPRITE_DATA_LEN bytes
+     */
+    void to_image(uint8_t *img) const noexcept;
+
+    /**
+     * Get the shape the image should be viewed as, when rendered with the given tile size.
+     * @param tile_size Tile width and height in pixels, one of SPRITE_TILE_SIZES
+     * @return array indicating observation HWC
+     * @throws std::invalid_argument if the tile size is not supported
+     */
+    [[nodiscard]] auto image_shape(std::size_t tile_size) const -> std::array<std::size_t, 3>;
+
+    /**
+     * Get the flat (HWC) image representation of the current state, rendered with the given tile size
+     * @param tile_size Tile width and height in pixels, one of SPRITE_TILE_SIZES
+     * @return flattened byte vector represending RGB values (HWC)
+     * @throws std::invalid_argument if the tile size is not supported
+     */
+    [[nodiscard]] auto to_image(std::size_t tile_size) const -> std::vector<uint8_t>;
+
+    /**
+     * Write the flat (HWC) image representation of the current state, rendered with the given tile size, into the
+     * given vector, resizing if needed
+     * @param img Vector to write the RGB values into
+     * @param tile_size Tile width and height in pixels, one of SPRITE_TILE_SIZES
+     * @throws std::invalid_argument if the tile size is not supported
+     */
+    void to_image(std::vector<uint8_t> &img, std::size_t tile_size) const;
+
+    /**
+     * Write the flat (HWC) image representation of the current state, rendered with the given tile size, into the
+     * given buffer
+     * @param img Pointer to a buffer of at least rows * cols * tile_size * tile_size * SPRITE_CHANNELS bytes
+     * @param tile_size Tile width and height in pixels, one of SPRITE_TILE_SIZES
+     * @throws std::invalid_argument if the tile size is not supported
+     */
+    void to_image(uint8_t *img, std::size_t tile_size) const;
+
     /**
      * Get the string representation of the underlying board
      */
@@ -313,12 +627,31 @@ public:
      */
     [[nodiscard]] auto get_reward_signal() const noexcept -> uint64_t;
 
+    /**
+     * Get the reward received as a result of the previous action taken.
+     * @return points collected during the previous step
+     */
+    [[nodiscard]] auto get_current_reward() const noexcept -> int;
+
+    /**
+     * Get the number of steps left before the level times out.
+     * @return steps remaining, or a negative value if the level has no step limit
+     */
+    [[nodiscard]] auto get_steps_remaining() const noexcept -> int;
+
     /**
      * Get the hash representation for the current state.
      * @return hash value
      */
     [[nodiscard]] auto get_hash() const noexcept -> uint64_t;
 
+    /**
+     * Get the memory held by this state, for search memory limits. The shared game parameters are not counted, as all
+     * states copied from the same state share them.
+     * @return Size of the object and the capacities of its board and local state buffers in bytes
+     */
+    [[nodiscard]] auto memory_bytes() const noexcept -> std::size_t;
+
     /**
      * Get all positions for a given element type
      * @param element The hidden cell type of the element to search for
@@ -377,10 +710,29 @@ public:
      */
     [[nodiscard]] auto get_hidden_item(std::size_t index) const noexcept -> HiddenCellType;
 
+    /**
+     * Get the visible cell item at the given index
+     */
+    [[nodiscard]] auto get_visible_item(std::size_t index) const noexcept -> VisibleCellType;
+
+    /**
+     * Compute the shortest walking distance of every cell to the nearest cell holding one of the target elements, with
+     * the agent moving through empty cells, dirt and the collectables it walks onto. The distance of the agent to the
+     * targets is then map.distance(get_agent_index()).
+     * @note The map buffers are reused, use a DistanceMapCache to also reuse the distances of states with the same
+     * terrain
+     * @param targets The hidden elements to compute distances to, such as kDiamond, the keys, or kExitClosed and
+     * kExitOpen
+     * @param map The distance map to fill
+     */
+    void get_distance_map(const std::vector<HiddenCellType> &targets, DistanceMap &map) const noexcept;
+
     // All possible actions
     static const std::vector<Action> ALL_ACTIONS;
 
     friend auto operator<<(std::ostream &os, const RNDGameState &state) -> std::ostream &;
+    friend class BatchSimulator;
+    friend void expand_shared(const RNDGameState &state, RNDGameState *children, ChildInfo *infos) noexcept;
 
 private:
     [[nodiscard]] auto IndexFromDirection(std::size_t index, Direction direction) const noexcept -> std::size_t;
@@ -426,12 +778,23 @@ private:
     void UpdateExplosions(std::size_t index) noexcept;
     void OpenGate(const Element &element) noexcept;
     void InitZrbhtTable() noexcept;
+    void BindCells() noexcept;
 
+    void UpdateCell(std::size_t index) noexcept;
     void StartScan() noexcept;
     void EndScan() noexcept;
+    void AddNeighbourhood(std::size_t index, std::size_t after, std::vector<std::size_t> &cells) const noexcept;
+    void ApplyNoopActive(const std::vector<std::size_t> &seeds) noexcept;
+    [[nodiscard]] auto IsAgentBlocked(Direction direction) const noexcept -> bool;
+    [[nodiscard]] auto IsAgentMoveIsolated(Direction direction) const noexcept -> bool;
+    [[nodiscard]] auto IsHazardIsolated(std::size_t index, std::size_t index_from, std::size_t index_to) const noexcept
+        -> bool;
+    void ApplyIsolatedMove(const RNDGameState &noop_child, Direction direction) noexcept;
+    void DrawTiles(uint8_t *img, std::size_t tile_size) const noexcept;
 
     std::shared_ptr<SharedStateInfo> shared_state_ptr;
     Board board;
+    BoardView cells;    // Cells the rules step, the vectors of board unless rebound by the BatchSimulator
     LocalState local_state;
 };
 
@@ -0,0 +1,80 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace stonesngems {
+
+ThreadPool::ThreadPool(std::size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::max(static_cast<std::size_t>(std::thread::hardware_concurrency()), std::size_t{1});
+    }
+    workers.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    cv_job.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+auto ThreadPool::num_threads() const noexcept -> std::size_t {
+    return workers.size();
+}
+
+void ThreadPool::run(const std::function<void(std::size_t)> &func) {
+    std::unique_lock<std::mutex> lock(mutex);
+    job = &func;
+    num_running = workers.size();
+    ++generation;
+    cv_job.notify_all();
+    cv_done.wait(lock, [&]() { return num_running == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::parallel_for(std::size_t n, const std::function<void(std::size_t, std::size_t, std::size_t)> &func) {
+    const std::size_t num_slices = workers.size();
+    run([&](std::size_t thread_idx) {
+        const std::size_t begin = n * thread_idx / num_slices;
+        const std::size_t end = n * (thread_idx + 1) / num_slices;
+        if (begin < end) {
+            func(begin, end, thread_idx);
+        }
+    });
+}
+
+void ThreadPool::WorkerLoop(std::size_t thread_idx) {
+    uint64_t last_generation = 0;
+    while (true) {
+        const std::function<void(std::size_t)> *current_job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv_job.wait(lock, [&]() { return stop || generation != last_generation; });
+            if (stop) {
+                return;
+            }
+            last_generation = generation;
+            current_job = job;
+        }
+        (*current_job)(thread_idx);
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            --num_running;
+        }
+        cv_done.notify_one();
+    }
+}
+
+}    // namespace stonesngems
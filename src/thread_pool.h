@@ -0,0 +1,64 @@
+#ifndef STONESNGEMS_THREAD_POOL_H_
+#define STONESNGEMS_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stonesngems {
+
+// Fixed size pool of worker threads, which all run the same job and block the caller until finished.
+// Jobs should only be submitted from a single thread at a time.
+class ThreadPool {
+public:
+    /**
+     * Create the pool and start the workers.
+     * @param num_threads Number of worker threads, 0 uses the hardware concurrency
+     */
+    explicit ThreadPool(std::size_t num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+    auto operator=(ThreadPool &&) -> ThreadPool & = delete;
+
+    /**
+     * Get the number of worker threads.
+     * @return Number of workers
+     */
+    [[nodiscard]] auto num_threads() const noexcept -> std::size_t;
+
+    /**
+     * Run the function once on every worker, blocking until all workers have finished.
+     * @param func Function taking the index of the worker it runs on
+     */
+    void run(const std::function<void(std::size_t)> &func);
+
+    /**
+     * Split [0, n) into contiguous slices, one per worker, blocking until all slices have been processed.
+     * @param n Number of items to process
+     * @param func Function taking the slice begin, end, and the index of the worker it runs on
+     */
+    void parallel_for(std::size_t n, const std::function<void(std::size_t, std::size_t, std::size_t)> &func);
+
+private:
+    void WorkerLoop(std::size_t thread_idx);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable cv_job;
+    std::condition_variable cv_done;
+    const std::function<void(std::size_t)> *job = nullptr;
+    uint64_t generation = 0;
+    std::size_t num_running = 0;
+    bool stop = false;
+};
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_THREAD_POOL_H_
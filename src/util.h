@@ -2,6 +2,7 @@
 #define STONESNGEMS_UTIL_H_
 
 #include <array>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
@@ -636,10 +637,32 @@ inline auto IsOpenGate(const Element &element) noexcept -> bool {
            element == kElGateYellowOpen;
 }
 
+inline auto IsClosedGate(const Element &element) noexcept -> bool {
+    return element == kElGateRedClosed || element == kElGateBlueClosed || element == kElGateGreenClosed ||
+           element == kElGateYellowClosed;
+}
+
 inline auto IsKey(const Element &element) noexcept -> bool {
     return element == kElKeyRed || element == kElKeyBlue || element == kElKeyGreen || element == kElKeyYellow;
 }
 
+// Hidden types which the board scan of apply_action dispatches an update for, as ranges of the enum so checks over many
+// cells compile to a few vector compares
+constexpr auto IsScanActive(HiddenCellType item) noexcept -> bool {
+    const auto t = static_cast<uint8_t>(item);
+    return static_cast<uint8_t>(t - to_underlying(HiddenCellType::kStone)) <= 4 ||        // kStone..kExitClosed
+           static_cast<uint8_t>(t - to_underlying(HiddenCellType::kFireflyUp)) <= 7 ||    // Fireflies, butterflies
+           static_cast<uint8_t>(t - to_underlying(HiddenCellType::kWallMagicDormant)) <= 6 ||    // Magic, blob, boom
+           static_cast<uint8_t>(t - to_underlying(HiddenCellType::kNut)) <= 7;    // Nuts, bombs, oranges
+}
+static_assert(!IsScanActive(HiddenCellType::kAgent) && !IsScanActive(HiddenCellType::kDirt) &&
+                  IsScanActive(HiddenCellType::kExitClosed) && !IsScanActive(HiddenCellType::kExitOpen) &&
+                  IsScanActive(HiddenCellType::kButterflyRight) && !IsScanActive(HiddenCellType::kWallSteel) &&
+                  IsScanActive(HiddenCellType::kExplosionEmpty) && !IsScanActive(HiddenCellType::kGateRedClosed) &&
+                  IsScanActive(HiddenCellType::kOrangeRight) && !IsScanActive(HiddenCellType::kPebbleInDirt) &&
+                  !IsScanActive(HiddenCellType::kNull),
+              "Scan active ranges out of sync with HiddenCellType");
+
 inline auto ElementToItem(const Element &element) noexcept -> std::underlying_type_t<HiddenCellType> {
     return to_underlying(element.cell_type);
 }
@@ -0,0 +1,128 @@
+#include "vector_env.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "definitions.h"
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+auto make_env_states(const std::vector<GameParameters> &params, const std::string &owner) -> std::vector<RNDGameState> {
+    if (params.empty()) {
+        throw std::invalid_argument(owner + " requires at least one environment");
+    }
+    std::vector<RNDGameState> states;
+    states.reserve(params.size());
+    for (const auto &p : params) {
+        states.emplace_back(p);
+        if (states.back().observation_shape() != states.front().observation_shape()) {
+            throw std::invalid_argument("All " + owner + " environments must have the same observation shape");
+        }
+    }
+    return states;
+}
+
+VectorEnv::VectorEnv(const std::vector<GameParameters> &params, std::size_t num_threads)
+    : initial_states(make_env_states(params, "VectorEnv")),
+      states(initial_states),
+      pool(num_threads == 1 ? nullptr : std::make_unique<ThreadPool>(num_threads)) {
+    const auto shape = initial_states.front().observation_shape();
+    obs_size = shape[0] * shape[1] * shape[2];
+    obs_buffer.resize(states.size() * obs_size);
+    reward_buffer.resize(states.size());
+    signal_buffer.resize(states.size());
+    terminal_buffer.resize(states.size());
+    reset();
+}
+
+VectorEnv::VectorEnv(const GameParameters &params, std::size_t num_envs, std::size_t num_threads)
+    : VectorEnv(std::vector<GameParameters>(num_envs, params), num_threads) {}
+
+auto VectorEnv::num_envs() const noexcept -> std::size_t {
+    return states.size();
+}
+
+auto VectorEnv::observation_shape() const noexcept -> std::array<std::size_t, 3> {
+    return initial_states.front().observation_shape();
+}
+
+void VectorEnv::reset() {
+    if (pool) {
+        pool->parallel_for(states.size(), [this](std::size_t begin, std::size_t end, std::size_t) {
+            ResetSlice(begin, end);
+        });
+    } else {
+        ResetSlice(0, states.size());
+    }
+}
+
+void VectorEnv::step(const Action *actions) {
+    if (pool) {
+        pool->parallel_for(states.size(), [this, actions](std::size_t begin, std::size_t end, std::size_t) {
+            StepSlice(actions, begin, end);
+        });
+    } else {
+        StepSlice(actions, 0, states.size());
+    }
+}
+
+void VectorEnv::step(const std::vector<Action> &actions) {
+    if (actions.size() != states.size()) {
+        throw std::invalid_argument("Expected one action per environment");
+    }
+    step(actions.data());
+}
+
+auto VectorEnv::observations() const noexcept -> const std::vector<float> & {
+    return obs_buffer;
+}
+
+auto VectorEnv::rewards() const noexcept -> const std::vector<int> & {
+    return reward_buffer;
+}
+
+auto VectorEnv::reward_signals() const noexcept -> const std::vector<uint64_t> & {
+    return signal_buffer;
+}
+
+auto VectorEnv::terminals() const noexcept -> const std::vector<uint8_t> & {
+    return terminal_buffer;
+}
+
+auto VectorEnv::get_state(std::size_t env_idx) const noexcept -> const RNDGameState & {
+    return states[env_idx];
+}
+
+void VectorEnv::StepSlice(const Action *actions, std::size_t begin, std::size_t end) noexcept {
+    for (std::size_t i = begin; i < end; ++i) {
+        RNDGameState &state = states[i];
+        state.apply_action(actions[i]);    // NOLINT(*-pointer-arithmetic)
+        reward_buffer[i] = state.get_current_reward();
+        signal_buffer[i] = state.get_reward_signal();
+        terminal_buffer[i] = static_cast<uint8_t>(state.is_terminal());
+        // Copy assignment reuses the existing buffers, and is cheaper than re-parsing the board string
+        if (terminal_buffer[i] != 0) {
+            state = initial_states[i];
+        }
+        state.get_observation(obs_buffer.data() + i * obs_size);
+    }
+}
+
+void VectorEnv::ResetSlice(std::size_t begin, std::size_t end) noexcept {
+    for (std::size_t i = begin; i < end; ++i) {
+        states[i] = initial_states[i];
+        reward_buffer[i] = 0;
+        signal_buffer[i] = 0;
+        terminal_buffer[i] = 0;
+        states[i].get_observation(obs_buffer.data() + i * obs_size);
+    }
+}
+
+}    // namespace stonesngems
@@ -0,0 +1,125 @@
+#ifndef STONESNGEMS_VECTOR_ENV_H_
+#define STONESNGEMS_VECTOR_ENV_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "definitions.h"
+#include "stonesngems_base.h"
+#include "thread_pool.h"
+
+namespace stonesngems {
+
+/**
+ * Create the initial states of a batch of environments, shared by VectorEnv and AsyncEnvPool.
+ * @param params Game parameters for each environment, all must produce the same observation shape
+ * @param owner Name of the batch type, used in the error messages
+ * @return One state per set of game parameters
+ * @throws std::invalid_argument if params is empty or the observation shapes differ
+ */
+auto make_env_states(const std::vector<GameParameters> &params, const std::string &owner) -> std::vector<RNDGameState>;
+
+// Batch of environments which are stepped together, writing their results into contiguous buffers.
+// Terminal environments are reset to their initial state during the same step, so the observation written for them is
+// the first observation of the next episode while the reward, signal, and terminal flag belong to the finished one.
+class VectorEnv {
+public:
+    /**
+     * Create one environment per set of game parameters.
+     * @param params Game parameters for each environment, all must produce the same observation shape
+     * @param num_threads Number of worker threads, 0 uses the hardware concurrency and 1 steps on the calling thread
+     * @throws std::invalid_argument if params is empty or the observation shapes differ
+     */
+    explicit VectorEnv(const std::vector<GameParameters> &params, std::size_t num_threads = 1);
+
+    /**
+     * Create copies of the same environment.
+     * @param params Game parameters shared by every environment
+     * @param num_envs Number of environments
+     * @param num_threads Number of worker threads, 0 uses the hardware concurrency and 1 steps on the calling thread
+     * @throws std::invalid_argument if num_envs is 0
+     */
+    VectorEnv(const GameParameters &params, std::size_t num_envs, std::size_t num_threads = 1);
+
+    /**
+     * Get the number of environments.
+     * @return Number of environments N
+     */
+    [[nodiscard]] auto num_envs() const noexcept -> std::size_t;
+
+    /**
+     * Get the observation shape of a single environment.
+     * @return array indicating observation CHW
+     */
+    [[nodiscard]] auto observation_shape() const noexcept -> std::array<std::size_t, 3>;
+
+    /**
+     * Reset every environment to its initial state, and write the initial observations.
+     */
+    void reset();
+
+    /**
+     * Apply one action to each environment, resetting those which become terminal.
+     * @param actions Pointer to N actions, one per environment
+     */
+    void step(const Action *actions);
+
+    /**
+     * Apply one action to each environment, resetting those which become terminal.
+     * @param actions Vector of N actions, one per environment
+     * @throws std::invalid_argument if the number of actions does not match the number of environments
+     */
+    void step(const std::vector<Action> &actions);
+
+    /**
+     * Get the observations of every environment.
+     * @return N x C x H x W flat vector, see RNDGameState::get_observation()
+     */
+    [[nodiscard]] auto observations() const noexcept -> const std::vector<float> &;
+
+    /**
+     * Get the rewards of the last step.
+     * @return N rewards, see RNDGameState::get_current_reward()
+     */
+    [[nodiscard]] auto rewards() const noexcept -> const std::vector<int> &;
+
+    /**
+     * Get the reward signals of the last step.
+     * @return N reward signals, see RNDGameState::get_reward_signal()
+     */
+    [[nodiscard]] auto reward_signals() const noexcept -> const std::vector<uint64_t> &;
+
+    /**
+     * Get the terminal flags of the last step.
+     * @return N flags, 1 if the environment finished its episode and was reset
+     */
+    [[nodiscard]] auto terminals() const noexcept -> const std::vector<uint8_t> &;
+
+    /**
+     * Get the current state of an environment.
+     * @param env_idx Index of the environment
+     * @return The state
+     */
+    [[nodiscard]] auto get_state(std::size_t env_idx) const noexcept -> const RNDGameState &;
+
+private:
+    void StepSlice(const Action *actions, std::size_t begin, std::size_t end) noexcept;
+    void ResetSlice(std::size_t begin, std::size_t end) noexcept;
+
+    std::vector<RNDGameState> initial_states;
+    std::vector<RNDGameState> states;
+    std::unique_ptr<ThreadPool> pool;
+    std::size_t obs_size;
+    std::vector<float> obs_buffer;
+    std::vector<int> reward_buffer;
+    std::vector<uint64_t> signal_buffer;
+    std::vector<uint8_t> terminal_buffer;
+};
+
+}    // namespace stonesngems
+
+#endif    // STONESNGEMS_VECTOR_ENV_H_
@@ -0,0 +1,145 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace stonesngems;
+
+#ifndef SNG_LEVELS_FILE
+#define SNG_LEVELS_FILE "bd_levels/bd_levels.txt"
+#endif
+
+namespace {
+constexpr std::size_t DEFAULT_MAX_MEMORY_MB = 4096;
+constexpr std::size_t DEFAULT_MCTS_MAX_STEPS = 2000;
+
+auto load_levels(const std::string &path) -> std::vector<std::string> {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument("Unable to open levels file " + path);
+    }
+    std::vector<std::string> levels;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            levels.push_back(line);
+        }
+    }
+    return levels;
+}
+
+// Replay the solution from the root to check it reaches a solution state
+auto verify_solution(const RNDGameState &state, const std::vector<Action> &solution) -> bool {
+    RNDGameState replay = state;
+    for (const auto action : solution) {
+        replay.apply_action(action);
+    }
+    return replay.is_solution();
+}
+
+void print_usage() {
+    std::cout << "usage: sng_solve [--levels FILE] [--level INDEX] [--solver bfs|external|mcts|beam|hda] "
+                 "[--threads N] [--max-depth D] [--max-memory-mb M] [--work-dir DIR] [--simulations S] "
+                 "[--beam-width W]"
+              << std::endl;
+}
+}    // namespace
+
+int main(int argc, char **argv) {
+    std::string levels_path = SNG_LEVELS_FILE;
+    int level_index = -1;
+    std::string solver = "bfs";
+    BFSOptions options;
+    options.num_threads = 0;
+    options.max_memory_mb = DEFAULT_MAX_MEMORY_MB;
+    ExternalBFSOptions external_options;
+    MCTSOptions mcts_options;
+    mcts_options.num_threads = 0;
+    BeamOptions beam_options;
+    beam_options.num_threads = 0;
+    HDAOptions hda_options;
+    hda_options.num_threads = 0;
+    hda_options.max_memory_mb = DEFAULT_MAX_MEMORY_MB;
+    // NOLINTBEGIN(*-pointer-arithmetic)
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            print_usage();
+            return EXIT_FAILURE;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--levels") {
+            levels_path = value;
+        } else if (arg == "--level") {
+            level_index = std::stoi(value);
+        } else if (arg == "--solver") {
+            solver = value;
+        } else if (arg == "--threads") {
+            options.num_threads = std::stoul(value);
+            mcts_options.num_threads = options.num_threads;
+            beam_options.num_threads = options.num_threads;
+            hda_options.num_threads = options.num_threads;
+        } else if (arg == "--max-depth") {
+            options.max_depth = std::stoul(value);
+            external_options.max_depth = options.max_depth;
+            beam_options.max_depth = options.max_depth;
+        } else if (arg == "--max-memory-mb") {
+            options.max_memory_mb = std::stoul(value);
+            hda_options.max_memory_mb = options.max_memory_mb;
+        } else if (arg == "--work-dir") {
+            external_options.work_dir = value;
+        } else if (arg == "--simulations") {
+            mcts_options.num_simulations = std::stoul(value);
+        } else if (arg == "--beam-width") {
+            beam_options.beam_width = std::stoul(value);
+        } else {
+            print_usage();
+            return EXIT_FAILURE;
+        }
+    }
+    // NOLINTEND(*-pointer-arithmetic)
+    if (solver != "bfs" && solver != "external" && solver != "mcts" && solver != "beam" && solver != "hda") {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<std::string> levels = load_levels(levels_path);
+    bool passed = true;
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        if (level_index >= 0 && static_cast<std::size_t>(level_index) != i) {
+            continue;
+        }
+        GameParameters params = kDefaultGameParams;
+        params["game_board_str"] = GameParameter(levels[i]);
+        const RNDGameState state(params);
+        SearchResult result;
+        if (solver == "external") {
+            result = external_bfs_solve(state, external_options);
+        } else if (solver == "mcts") {
+            const std::size_t max_steps = options.max_depth > 0 ? options.max_depth : DEFAULT_MCTS_MAX_STEPS;
+            result = mcts_solve(state, mcts_options, max_steps);
+        } else if (solver == "beam") {
+            result = beam_search(state, beam_options);
+        } else if (solver == "hda") {
+            result = hda_solve(state, hda_options);
+        } else {
+            result = bfs_solve(state, options);
+        }
+        std::cout << "level " << i << ": ";
+        if (result.solved) {
+            const bool verified = verify_solution(state, result.solution);
+            passed = passed && verified;
+            std::cout << "solved in " << result.solution.size() << " steps" << (verified ? "" : " (INVALID)");
+        } else {
+            std::cout << (result.hit_limit ? "stopped at limit" : "unsolvable");
+        }
+        std::cout << ", expanded " << result.nodes_expanded << ", generated " << result.nodes_generated << ", "
+                  << result.seconds << " s, " << result.nodes_per_second() << " nodes/s" << std::endl;
+    }
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
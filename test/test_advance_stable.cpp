@@ -0,0 +1,172 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace stonesngems;
+
+// Pushing the stone right drops it three cells onto the bomb, whose explosion clears the bottom
+const std::string PUSH_BOARD_STR =
+    "7|6|-1|0|"
+    "19|19|19|19|19|19|"
+    "19|00|03|01|02|19|"
+    "19|02|02|01|02|19|"
+    "19|02|02|01|02|19|"
+    "19|02|02|01|02|19|"
+    "19|02|02|41|02|19|"
+    "19|19|19|19|19|19";
+
+// As above, with a firefly circling in a steel walled pocket on the right
+const std::string FIREFLY_BOARD_STR =
+    "7|8|-1|0|"
+    "19|19|19|19|19|19|19|19|"
+    "19|00|03|01|19|01|01|19|"
+    "19|02|02|01|19|10|01|19|"
+    "19|02|02|01|19|01|01|19|"
+    "19|02|02|01|19|02|02|19|"
+    "19|02|02|41|19|02|02|19|"
+    "19|19|19|19|19|19|19|19";
+
+// Small level with magic walls, a blob, nuts, bombs, oranges, fireflies, butterflies and a gate
+const std::string MIXED_BOARD_STR =
+    "10|12|200|3|"
+    "19|19|19|19|19|19|19|19|19|19|19|19|"
+    "19|00|01|02|03|05|02|39|41|02|46|19|"
+    "19|02|03|01|01|02|01|01|01|10|01|19|"
+    "19|01|20|20|20|02|14|01|01|01|01|19|"
+    "19|01|01|01|01|02|01|03|03|05|02|19|"
+    "19|23|02|01|02|29|27|01|01|01|01|19|"
+    "19|02|01|40|01|02|18|41|02|01|44|19|"
+    "19|01|05|01|03|01|07|01|01|02|01|19|"
+    "19|02|01|02|01|02|01|01|43|01|01|19|"
+    "19|19|19|19|19|19|19|19|19|19|19|19";
+
+auto has_unsettled(const RNDGameState &state) -> bool {
+    for (const auto element : {HiddenCellType::kStoneFalling, HiddenCellType::kDiamondFalling,
+                               HiddenCellType::kNutFalling, HiddenCellType::kBombFalling,
+                               HiddenCellType::kExplosionDiamond, HiddenCellType::kExplosionBoulder,
+                               HiddenCellType::kExplosionEmpty}) {
+        if (!state.get_indices(element).empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+auto test_advance_until_stable() -> bool {
+    RNDGameState state = make_state(PUSH_BOARD_STR);
+    state.apply_action(Action::kRight);
+    // Reference: tick by hand, checking the whole board after every tick
+    RNDGameState expected = state;
+    std::size_t expected_ticks = 0;
+    while (has_unsettled(expected)) {
+        expected.apply_action(Action::kNoop);
+        ++expected_ticks;
+    }
+    const StableResult result = state.advance_until_stable(100);
+    if (expected_ticks < 3 || result.ticks != expected_ticks || !result.stable || result.perpetual ||
+        state != expected) {
+        std::cout << "Settled after " << result.ticks << " ticks, expected " << expected_ticks << "." << std::endl;
+        return false;
+    }
+    // A settled board needs no ticks
+    const StableResult again = state.advance_until_stable(100);
+    if (again.ticks != 0 || !again.stable) {
+        std::cout << "Settled board was ticked again." << std::endl;
+        return false;
+    }
+    std::cout << "Board settled after " << result.ticks << " ticks." << std::endl;
+    return true;
+}
+
+auto test_advance_until_stable_limit() -> bool {
+    RNDGameState state = make_state(PUSH_BOARD_STR);
+    state.apply_action(Action::kRight);
+    const StableResult result = state.advance_until_stable(1);
+    if (result.ticks != 1 || result.stable) {
+        std::cout << "Tick limit not respected." << std::endl;
+        return false;
+    }
+    std::cout << "Tick limit respected." << std::endl;
+    return true;
+}
+
+auto test_advance_until_stable_perpetual() -> bool {
+    RNDGameState state = make_state(FIREFLY_BOARD_STR);
+    state.apply_action(Action::kRight);
+    const StableResult result = state.advance_until_stable(100);
+    if (!result.stable || !result.perpetual || result.ticks >= 100) {
+        std::cout << "Firefly board not reported as perpetual." << std::endl;
+        return false;
+    }
+    std::cout << "Firefly board settled but perpetual." << std::endl;
+    return true;
+}
+
+auto has_perpetual(const RNDGameState &state) -> bool {
+    for (const auto element : {HiddenCellType::kBlob, HiddenCellType::kFireflyUp, HiddenCellType::kFireflyLeft,
+                               HiddenCellType::kFireflyDown, HiddenCellType::kFireflyRight,
+                               HiddenCellType::kButterflyUp, HiddenCellType::kButterflyLeft,
+                               HiddenCellType::kButterflyDown, HiddenCellType::kButterflyRight,
+                               HiddenCellType::kOrangeUp, HiddenCellType::kOrangeLeft, HiddenCellType::kOrangeDown,
+                               HiddenCellType::kOrangeRight}) {
+        if (!state.get_indices(element).empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Ticks which only scan the active cells must match full apply_action(kNoop) ticks, including the rng, the rewards and
+// the changed cells of the last tick
+auto test_advance_until_stable_matches_full_ticks() -> bool {
+    constexpr std::size_t kMaxTicks = 30;
+    uint64_t rng = 1;
+    int num_compared = 0;
+    for (const auto &board_str : {MIXED_BOARD_STR, PUSH_BOARD_STR, FIREFLY_BOARD_STR, std::string()}) {
+        for (int walk = 0; walk < 10; ++walk) {
+            RNDGameState state = board_str.empty() ? RNDGameState() : make_state(board_str);
+            for (int step = 0; step < 30 && !state.is_terminal(); ++step) {
+                rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+                state.apply_action(RNDGameState::ALL_ACTIONS[(rng >> 33) % RNDGameState::ALL_ACTIONS.size()]);
+                RNDGameState expected = state;
+                std::size_t expected_ticks = 0;
+                uint64_t expected_signal = 0;
+                int expected_reward = 0;
+                while (has_unsettled(expected) && expected_ticks < kMaxTicks && !expected.is_terminal()) {
+                    expected.apply_action(Action::kNoop);
+                    ++expected_ticks;
+                    expected_signal |= expected.get_reward_signal();
+                    expected_reward += expected.get_current_reward();
+                    if (expected.get_changed_indices().empty() && !has_perpetual(expected)) {
+                        break;
+                    }
+                }
+                RNDGameState advanced = state;
+                const StableResult result = advanced.advance_until_stable(kMaxTicks);
+                if (result.ticks != expected_ticks || result.reward_signal != expected_signal ||
+                    result.reward != expected_reward || advanced.serialize() != expected.serialize() ||
+                    advanced.get_changed_indices() != expected.get_changed_indices()) {
+                    std::cout << "Active cell ticks differ from full ticks after " << result.ticks << " ticks."
+                              << std::endl;
+                    return false;
+                }
+                num_compared += static_cast<int>(expected_ticks > 1);
+            }
+        }
+    }
+    std::cout << "Active cell ticks match full ticks on " << num_compared << " runs." << std::endl;
+    return num_compared > 0;
+}
+
+int main() {
+    const bool passed = test_advance_until_stable() && test_advance_until_stable_limit() &&
+                        test_advance_until_stable_perpetual() && test_advance_until_stable_matches_full_ticks();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,95 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "test_util.h"
+
+using namespace stonesngems;
+
+// The direct route passes below a stone, the safe route goes around through the bottom row
+const std::string STONE_BOARD_STR =
+    "5|7|-1|0|"
+    "19|19|19|19|19|19|19|"
+    "19|18|18|03|18|18|19|"
+    "19|00|02|02|02|02|19|"
+    "19|01|01|01|01|01|19|"
+    "19|19|19|19|19|19|19";
+
+// The stone falls next to the path on the first tick
+const std::string FALLING_BOARD_STR =
+    "5|7|-1|0|"
+    "19|19|19|19|19|19|19|"
+    "19|01|01|01|03|01|19|"
+    "19|18|18|18|01|18|19|"
+    "19|00|01|01|01|01|19|"
+    "19|19|19|19|19|19|19";
+
+auto test_apply_path_small() -> bool {
+    RNDGameState state = make_state(SMALL_BOARD_STR);
+    RNDGameState expected = state;
+    for (const auto action : {Action::kRight, Action::kRight, Action::kRight, Action::kDown, Action::kDown}) {
+        expected.apply_action(action);
+    }
+    const PathResult to_diamond = state.apply_path_to(state.get_indices(HiddenCellType::kDiamond)[0]);
+    if (to_diamond.ticks != 2 || !to_diamond.reached ||
+        (to_diamond.reward_signal & RewardCodes::kRewardCollectDiamond) == 0 || to_diamond.reward == 0) {
+        std::cout << "Walk to the diamond took " << to_diamond.ticks << " ticks." << std::endl;
+        return false;
+    }
+    const PathResult to_exit = state.apply_path_to(state.get_indices(HiddenCellType::kExitOpen)[0]);
+    if (to_exit.ticks != 3 || !to_exit.reached || !state.is_solution() || state != expected) {
+        std::cout << "Walk to the exit took " << to_exit.ticks << " ticks." << std::endl;
+        return false;
+    }
+    std::cout << "Walked the small board in two macro moves." << std::endl;
+    return true;
+}
+
+auto test_apply_path_no_path() -> bool {
+    RNDGameState state = make_state(SMALL_BOARD_STR);
+    const RNDGameState before = state;
+    const PathResult to_wall = state.apply_path_to(0);
+    // The exit is still closed, so it is not walkable
+    const PathResult to_exit = state.apply_path_to(state.get_indices(HiddenCellType::kExitClosed)[0]);
+    const PathResult to_self = state.apply_path_to(state.get_agent_index());
+    if (to_wall.ticks != 0 || to_wall.reached || to_exit.ticks != 0 || to_exit.reached || to_self.ticks != 0 ||
+        !to_self.reached || state != before) {
+        std::cout << "Walk without a path changed the state." << std::endl;
+        return false;
+    }
+    std::cout << "Walk without a path leaves the state unchanged." << std::endl;
+    return true;
+}
+
+auto test_apply_path_safe() -> bool {
+    RNDGameState state = make_state(STONE_BOARD_STR);
+    const std::size_t target = state.position_to_index({2, 5});
+    const PathResult result = state.apply_path_to(target);
+    const bool dirt_left = state.get_hidden_item(state.position_to_index({2, 3})) == HiddenCellType::kDirt;
+    if (result.ticks != 6 || !result.reached || !dirt_left) {
+        std::cout << "Walk went below the stone, " << result.ticks << " ticks." << std::endl;
+        return false;
+    }
+    std::cout << "Walk went around the stone." << std::endl;
+    return true;
+}
+
+auto test_apply_path_interrupted() -> bool {
+    RNDGameState state = make_state(FALLING_BOARD_STR);
+    const PathResult result = state.apply_path_to(state.position_to_index({3, 5}));
+    if (result.ticks != 1 || result.reached || state.get_agent_index() != state.position_to_index({3, 2})) {
+        std::cout << "Walk was not interrupted by the falling stone, " << result.ticks << " ticks." << std::endl;
+        return false;
+    }
+    std::cout << "Walk interrupted by the falling stone." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed =
+        test_apply_path_small() && test_apply_path_no_path() && test_apply_path_safe() && test_apply_path_interrupted();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
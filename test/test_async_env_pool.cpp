@@ -0,0 +1,92 @@
+#include <rnd/stonesngems.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace stonesngems;
+
+constexpr std::size_t NUM_ENVS = 16;
+constexpr std::size_t BATCH_SIZE = 5;
+constexpr std::size_t NUM_ROUNDS = 400;
+
+// Step an AsyncEnvPool, replaying the same actions on individual states as environments are received
+auto test_async_env_pool(std::size_t num_threads) -> bool {
+    std::vector<GameParameters> params;
+    for (std::size_t i = 0; i < NUM_ENVS; ++i) {
+        GameParameters p = kDefaultGameParams;
+        p["rng_seed"] = GameParameter(static_cast<int>(i));
+        params.push_back(p);
+    }
+    AsyncEnvPool pool(params, num_threads);
+    std::vector<RNDGameState> states;
+    for (const auto &p : params) {
+        states.emplace_back(p);
+    }
+    const std::size_t obs_size = states.front().get_observation().size();
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> dist(0, RNDGameState::action_space_size() - 1);
+    std::vector<Action> last_actions(NUM_ENVS, Action::kNoop);
+    std::vector<uint8_t> stepped(NUM_ENVS, 0);
+
+    auto check_env = [&](std::size_t env_id) -> bool {
+        RNDGameState &state = states[env_id];
+        bool terminal = false;
+        if (stepped[env_id] != 0) {
+            state.apply_action(last_actions[env_id]);
+            terminal = state.is_terminal();
+            if (pool.rewards()[env_id] != state.get_current_reward() ||
+                pool.reward_signals()[env_id] != state.get_reward_signal()) {
+                return false;
+            }
+            if (terminal) {
+                state.reset();
+            }
+        }
+        const std::vector<float> obs = state.get_observation();
+        const auto pool_obs = pool.observations().begin() + static_cast<std::ptrdiff_t>(env_id * obs_size);
+        return (pool.terminals()[env_id] != 0) == terminal && std::equal(obs.begin(), obs.end(), pool_obs);
+    };
+
+    auto send_envs = [&](const std::vector<std::size_t> &env_ids) {
+        std::vector<Action> actions;
+        for (const auto env_id : env_ids) {
+            last_actions[env_id] = ALL_ACTIONS[dist(gen)];    // NOLINT(*-bounds-constant-array-index)
+            stepped[env_id] = 1;
+            actions.push_back(last_actions[env_id]);
+        }
+        pool.send(env_ids, actions);
+    };
+
+    pool.reset();
+    std::vector<std::size_t> env_ids = pool.recv(NUM_ENVS);
+    for (const auto env_id : env_ids) {
+        if (!check_env(env_id)) {
+            std::cout << "AsyncEnvPool reset error for environment " << env_id << "." << std::endl;
+            return false;
+        }
+    }
+    send_envs(env_ids);
+    for (std::size_t round = 0; round < NUM_ROUNDS; ++round) {
+        pool.recv(BATCH_SIZE, env_ids);
+        for (const auto env_id : env_ids) {
+            if (!check_env(env_id)) {
+                std::cout << "AsyncEnvPool step error for environment " << env_id << " in round " << round << "."
+                          << std::endl;
+                return false;
+            }
+        }
+        send_envs(env_ids);
+    }
+    pool.recv(NUM_ENVS, env_ids);
+    std::cout << "AsyncEnvPool with " << pool.num_threads() << " threads matches individual states." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_async_env_pool(1) && test_async_env_pool(4);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
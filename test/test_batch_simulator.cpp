@@ -0,0 +1,133 @@
+#include <rnd/stonesngems.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace stonesngems;
+
+constexpr std::size_t NUM_INSTANCES = 17;
+constexpr std::size_t NUM_STEPS = 400;
+
+const std::string BOARD_STR =
+    "14|14|-1|1|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18|07|01|01|18|01|01|01|01|18|02|02|05|18|18|02|01|01|18|"
+    "02|02|02|02|18|02|32|01|18|18|01|01|02|36|02|02|02|01|18|01|01|02|18|18|18|18|18|18|01|01|01|01|18|34|18|18|"
+    "18|18|01|02|02|01|01|02|02|02|01|02|02|02|18|18|02|02|02|35|02|01|02|02|02|02|01|01|18|18|01|01|02|02|01|02|"
+    "02|01|02|02|01|01|18|18|02|02|02|01|02|01|01|02|01|01|02|02|18|18|18|18|18|18|00|02|01|01|18|18|18|18|18|18|"
+    "01|01|29|18|02|01|02|02|18|02|01|02|18|18|02|01|02|18|02|01|02|02|18|02|02|01|18|18|01|01|01|31|01|01|02|01|"
+    "28|01|38|02|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18";
+
+// Small level with magic walls, a blob, nuts, bombs, oranges, fireflies, butterflies and a gate
+const std::string MIXED_BOARD_STR =
+    "10|12|200|3|"
+    "19|19|19|19|19|19|19|19|19|19|19|19|"
+    "19|00|01|02|03|05|02|39|41|02|46|19|"
+    "19|02|03|01|01|02|01|01|01|10|01|19|"
+    "19|01|20|20|20|02|14|01|01|01|01|19|"
+    "19|01|01|01|01|02|01|03|03|05|02|19|"
+    "19|23|02|01|02|29|27|01|01|01|01|19|"
+    "19|02|01|40|01|02|18|41|02|01|44|19|"
+    "19|01|05|01|03|01|07|01|01|02|01|19|"
+    "19|02|01|02|01|02|01|01|43|01|01|19|"
+    "19|19|19|19|19|19|19|19|19|19|19|19";
+
+// Step a BatchSimulator and the same states one at a time with random actions, checking every instance matches
+auto test_batch_simulator(const GameParameters &params, const std::string &name, std::size_t &num_terminals) -> bool {
+    const RNDGameState start_state(params);
+    BatchSimulator sim(start_state, NUM_INSTANCES);
+    std::vector<RNDGameState> states(NUM_INSTANCES, start_state);
+    RNDGameState extracted = start_state;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> dist(0, RNDGameState::action_space_size() - 1);
+    std::vector<Action> actions(NUM_INSTANCES);
+    for (std::size_t step = 0; step < NUM_STEPS; ++step) {
+        for (auto &action : actions) {
+            action = ALL_ACTIONS[dist(gen)];    // NOLINT(*-bounds-constant-array-index)
+        }
+        sim.step(actions);
+        for (std::size_t i = 0; i < NUM_INSTANCES; ++i) {
+            RNDGameState &state = states[i];
+            state.apply_action(actions[i]);
+            sim.get_instance(i, extracted);
+            if (sim.get_hash(i) != state.get_hash() || sim.get_current_reward(i) != state.get_current_reward() ||
+                sim.get_reward_signal(i) != state.get_reward_signal() || sim.is_terminal(i) != state.is_terminal() ||
+                sim.is_solution(i) != state.is_solution()) {
+                std::cout << "BatchSimulator step result error on " << name << " at step " << step << "."
+                          << std::endl;
+                return false;
+            }
+            if (extracted != state || extracted.get_hash() != state.get_hash() ||
+                extracted.get_agent_pos() != state.get_agent_pos() ||
+                extracted.get_changed_indices() != state.get_changed_indices() ||
+                extracted.get_index_id(state.get_agent_index()) != state.get_index_id(state.get_agent_index())) {
+                std::cout << "BatchSimulator instance error on " << name << " at step " << step << "." << std::endl;
+                return false;
+            }
+            if (state.is_terminal()) {
+                state = start_state;
+                sim.set_instance(i, state);
+                ++num_terminals;
+            }
+        }
+    }
+    std::cout << "BatchSimulator matches individual states on " << name << "." << std::endl;
+    return true;
+}
+
+auto test_batch_simulator_levels() -> bool {
+    GameParameters board_params = kDefaultGameParams;
+    board_params["game_board_str"] = GameParameter(BOARD_STR);
+    GameParameters mixed_params = kDefaultGameParams;
+    mixed_params["game_board_str"] = GameParameter(MIXED_BOARD_STR);
+    mixed_params["blob_chance"] = GameParameter(64);
+    GameParameters convert_params = mixed_params;
+    convert_params["butterfly_explosion_ver"] = GameParameter(static_cast<int>(ButterflyExplosionVersion::kConvert));
+    convert_params["butterfly_move_ver"] = GameParameter(static_cast<int>(ButterflyMoveVersion::kInstant));
+    std::size_t num_terminals = 0;
+    const bool passed =
+        test_batch_simulator(kDefaultGameParams, "default board", num_terminals) &&
+        test_batch_simulator(board_params, "gate board", num_terminals) &&
+        test_batch_simulator(mixed_params, "mixed board", num_terminals) &&
+        test_batch_simulator(convert_params, "mixed board with butterfly conversion", num_terminals);
+    if (passed && num_terminals == 0) {
+        std::cout << "BatchSimulator never reached a terminal." << std::endl;
+        return false;
+    }
+    return passed;
+}
+
+auto test_batch_simulator_errors() -> bool {
+    const RNDGameState state;
+    try {
+        const BatchSimulator sim(state, 0);
+        std::cout << "BatchSimulator accepted zero instances." << std::endl;
+        return false;
+    } catch (const std::invalid_argument &) {
+    }
+    BatchSimulator sim(state, 2);
+    try {
+        sim.step(std::vector<Action>(3, Action::kNoop));
+        std::cout << "BatchSimulator accepted wrong number of actions." << std::endl;
+        return false;
+    } catch (const std::invalid_argument &) {
+    }
+    GameParameters other = kDefaultGameParams;
+    other["game_board_str"] = GameParameter(BOARD_STR);
+    try {
+        sim.set_instance(0, RNDGameState(other));
+        std::cout << "BatchSimulator accepted state from another level." << std::endl;
+        return false;
+    } catch (const std::invalid_argument &) {
+    }
+    std::cout << "BatchSimulator errors handled." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_batch_simulator_levels() && test_batch_simulator_errors();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
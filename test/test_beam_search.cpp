@@ -0,0 +1,52 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace stonesngems;
+
+// A beam wide enough for every state of a layer is a breadth-first search, and finds the shortest solution
+auto test_beam_search(std::size_t num_threads) -> bool {
+    const RNDGameState state = make_state(SMALL_BOARD_STR);
+    BeamOptions options;
+    options.num_threads = num_threads;
+    options.bucket_size = 0;
+    const std::string name = "Beam search with " + std::to_string(num_threads) + " threads";
+    if (!check_solution(state, beam_search(state, options), name, SMALL_BOARD_SOLUTION_LENGTH)) {
+        return false;
+    }
+    // Keeping a single state per agent cell still reaches the exit along a shortest path on this level
+    options.bucket_size = 1;
+    return check_solution(state, beam_search(state, options), name + " and buckets", SMALL_BOARD_SOLUTION_LENGTH);
+}
+
+auto test_beam_search_limits() -> bool {
+    const RNDGameState state = make_state(UNSOLVABLE_BOARD_STR);
+    BeamOptions options;
+    options.max_depth = 20;
+    const SearchResult result = beam_search(state, options);
+    if (result.solved || !result.hit_limit || result.nodes_expanded == 0) {
+        std::cout << "Beam search should stop at the depth limit." << std::endl;
+        return false;
+    }
+    options.beam_width = 0;
+    try {
+        static_cast<void>(beam_search(state, options));
+        std::cout << "Beam search accepted a width of 0." << std::endl;
+        return false;
+    } catch (const std::invalid_argument &) {
+    }
+    std::cout << "Beam search stops at the depth limit." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_beam_search(1) && test_beam_search(3) && test_beam_search_limits();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
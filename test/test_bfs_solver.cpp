@@ -0,0 +1,42 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace stonesngems;
+
+auto test_bfs_solve(std::size_t num_threads) -> bool {
+    const RNDGameState state = make_state(SMALL_BOARD_STR);
+    BFSOptions options;
+    options.num_threads = num_threads;
+    const std::string name = "BFS with " + std::to_string(num_threads) + " threads";
+    return check_solution(state, bfs_solve(state, options), name, SMALL_BOARD_SOLUTION_LENGTH);
+}
+
+auto test_bfs_unsolvable() -> bool {
+    const RNDGameState state = make_state(UNSOLVABLE_BOARD_STR);
+    BFSOptions options;
+    options.num_threads = 2;
+    const SearchResult result = bfs_solve(state, options);
+    if (result.solved || result.hit_limit || result.nodes_expanded == 0) {
+        std::cout << "BFS should exhaust the unsolvable level." << std::endl;
+        return false;
+    }
+    options.max_depth = 1;
+    if (bfs_solve(state, options).hit_limit != true) {
+        std::cout << "BFS did not stop at the depth limit." << std::endl;
+        return false;
+    }
+    std::cout << "BFS exhausts unsolvable level." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_bfs_solve(1) && test_bfs_solve(3) && test_bfs_unsolvable();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,164 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace stonesngems;
+
+// The small level with a brick wall and a stone in the way, so the distances have to route around them
+const std::string OBSTACLE_BOARD_STR =
+    "5|6|-1|1|"
+    "19|19|19|19|19|19|"
+    "19|00|02|05|01|19|"
+    "19|02|18|02|01|19|"
+    "19|01|01|03|07|19|"
+    "19|19|19|19|19|19";
+
+auto is_walkable(HiddenCellType element) -> bool {
+    switch (element) {
+        case HiddenCellType::kAgent:
+        case HiddenCellType::kEmpty:
+        case HiddenCellType::kDirt:
+        case HiddenCellType::kDiamond:
+        case HiddenCellType::kDiamondFalling:
+        case HiddenCellType::kExitOpen:
+        case HiddenCellType::kAgentInExit:
+        case HiddenCellType::kKeyRed:
+        case HiddenCellType::kKeyBlue:
+        case HiddenCellType::kKeyGreen:
+        case HiddenCellType::kKeyYellow:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Plain queue based BFS from the targets as the reference
+auto reference_distances(const RNDGameState &state, const std::vector<HiddenCellType> &targets) -> std::vector<int> {
+    const auto shape = state.observation_shape();
+    const std::size_t rows = shape[1];
+    const std::size_t cols = shape[2];
+    std::vector<int> distances(rows * cols, DistanceMap::kUnreachable);
+    std::deque<std::size_t> queue;
+    for (const auto element : targets) {
+        for (const auto idx : state.get_indices(element)) {
+            distances[idx] = 0;
+            queue.push_back(idx);
+        }
+    }
+    while (!queue.empty()) {
+        const std::size_t idx = queue.front();
+        queue.pop_front();
+        std::vector<std::size_t> neighbours;
+        if (idx % cols != 0) {
+            neighbours.push_back(idx - 1);
+        }
+        if (idx % cols != cols - 1) {
+            neighbours.push_back(idx + 1);
+        }
+        if (idx >= cols) {
+            neighbours.push_back(idx - cols);
+        }
+        if (idx + cols < rows * cols) {
+            neighbours.push_back(idx + cols);
+        }
+        for (const auto n : neighbours) {
+            if (distances[n] == DistanceMap::kUnreachable && is_walkable(state.get_hidden_item(n))) {
+                distances[n] = distances[idx] + 1;
+                queue.push_back(n);
+            }
+        }
+    }
+    return distances;
+}
+
+auto test_distance_map_small() -> bool {
+    const RNDGameState state = make_state(OBSTACLE_BOARD_STR);
+    DistanceMap map;
+    state.get_distance_map({HiddenCellType::kDiamond}, map);
+    const int to_diamond = map.distance(state.get_agent_index());
+    state.get_distance_map({HiddenCellType::kExitClosed, HiddenCellType::kExitOpen}, map);
+    const int to_exit = map.distance(state.get_agent_index());
+    // The stone blocks the bottom row, so the exit is reached from above
+    if (to_diamond != 2 || to_exit != 5 || map.distance(state.get_indices(HiddenCellType::kWallBrick)[0]) != -1) {
+        std::cout << "Small board distances " << to_diamond << " and " << to_exit << " are wrong." << std::endl;
+        return false;
+    }
+    std::cout << "Small board distances correct." << std::endl;
+    return true;
+}
+
+auto test_distance_map_reference() -> bool {
+    RNDGameState state;
+    const std::vector<std::vector<HiddenCellType>> target_sets{
+        {HiddenCellType::kDiamond}, {HiddenCellType::kExitClosed}, {HiddenCellType::kStone, HiddenCellType::kAgent}};
+    DistanceMap map;
+    for (int step = 0; step < 40; ++step) {
+        for (const auto &targets : target_sets) {
+            state.get_distance_map(targets, map);
+            if (map.get_distances() != reference_distances(state, targets)) {
+                std::cout << "Distance map differs from the reference at step " << step << "." << std::endl;
+                return false;
+            }
+        }
+        state.apply_action(step % 3 == 0 ? Action::kDown : Action::kRight);
+    }
+    std::cout << "Distance maps match the reference BFS." << std::endl;
+    return true;
+}
+
+auto test_distance_map_cache() -> bool {
+    RNDGameState state;
+    // Let the stones of the level settle first
+    for (int step = 0; step < 50; ++step) {
+        state.apply_action(Action::kNoop);
+        if (state.get_changed_indices().empty()) {
+            break;
+        }
+    }
+    DistanceMapCache cache(8);
+    const std::vector<HiddenCellType> targets{HiddenCellType::kExitClosed};
+    const DistanceMap &first = cache.get(state, targets);
+    const std::vector<int> distances = first.get_distances();
+    // Digging through dirt keeps the walkable terrain, so the same map is reused
+    state.apply_action(Action::kDown);
+    const DistanceMap &second = cache.get(state, targets);
+    if (cache.hits() != 1 || cache.misses() != 1 || second.get_distances() != distances) {
+        std::cout << "Distance map cache missed on unchanged terrain." << std::endl;
+        return false;
+    }
+    // Other targets are other terrain
+    DistanceMap expected;
+    state.get_distance_map({HiddenCellType::kDiamond}, expected);
+    if (cache.get(state, {HiddenCellType::kDiamond}).get_distances() != expected.get_distances() ||
+        cache.misses() != 2) {
+        std::cout << "Distance map cache hit for different targets." << std::endl;
+        return false;
+    }
+    cache.clear();
+    static_cast<void>(cache.get(state, targets));
+    if (cache.misses() != 3) {
+        std::cout << "Distance map cache hit after clear." << std::endl;
+        return false;
+    }
+    try {
+        const DistanceMapCache empty(0);
+        std::cout << "Distance map cache accepted a capacity of 0." << std::endl;
+        return false;
+    } catch (const std::invalid_argument &) {
+    }
+    std::cout << "Distance map cache reuses maps of unchanged terrain." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_distance_map_small() && test_distance_map_reference() && test_distance_map_cache();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,132 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define SNG_TEST_COUNT_ALLOCATIONS
+#include "test_util.h"
+
+using namespace stonesngems;
+
+constexpr std::size_t NUM_STEPS = 500;
+
+const std::string BOARD_STR =
+    "14|14|-1|1|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18|07|01|01|18|01|01|01|01|18|02|02|05|18|18|02|01|01|18|"
+    "02|02|02|02|18|02|32|01|18|18|01|01|02|36|02|02|02|01|18|01|01|02|18|18|18|18|18|18|01|01|01|01|18|34|18|18|"
+    "18|18|01|02|02|01|01|02|02|02|01|02|02|02|18|18|02|02|02|35|02|01|02|02|02|02|01|01|18|18|01|01|02|02|01|02|"
+    "02|01|02|02|01|01|18|18|02|02|02|01|02|01|01|02|01|01|02|02|18|18|18|18|18|18|00|02|01|01|18|18|18|18|18|18|"
+    "01|01|29|18|02|01|02|02|18|02|01|02|18|18|02|01|02|18|02|01|02|02|18|02|02|01|18|18|01|01|01|31|01|01|02|01|"
+    "28|01|38|02|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18";
+
+// Small level with magic walls, a blob, nuts, bombs, oranges, fireflies, butterflies and a gate
+const std::string MIXED_BOARD_STR =
+    "10|12|200|3|"
+    "19|19|19|19|19|19|19|19|19|19|19|19|"
+    "19|00|01|02|03|05|02|39|41|02|46|19|"
+    "19|02|03|01|01|02|01|01|01|10|01|19|"
+    "19|01|20|20|20|02|14|01|01|01|01|19|"
+    "19|01|01|01|01|02|01|03|03|05|02|19|"
+    "19|23|02|01|02|29|27|01|01|01|01|19|"
+    "19|02|01|40|01|02|18|41|02|01|44|19|"
+    "19|01|05|01|03|01|07|01|01|02|01|19|"
+    "19|02|01|02|01|02|01|01|43|01|01|19|"
+    "19|19|19|19|19|19|19|19|19|19|19|19";
+
+// Expand along a random walk, checking each child against copying the parent and applying the action
+auto test_expand_matches_apply() -> bool {
+    RNDGameState state;
+    std::vector<RNDGameState> children;
+    std::vector<ChildInfo> infos;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> dist(0, kNumChildren - 1);
+    for (std::size_t step = 0; step < NUM_STEPS; ++step) {
+        expand(state, children, infos);
+        if (children.size() != kNumChildren || infos.size() != kNumChildren) {
+            std::cout << "Expand output size error." << std::endl;
+            return false;
+        }
+        for (std::size_t i = 0; i < kNumChildren; ++i) {
+            RNDGameState child = state;
+            child.apply_action(ALL_ACTIONS[i]);    // NOLINT(*-bounds-constant-array-index)
+            const ChildInfo &info = infos[i];
+            if (children[i] != child || children[i].get_hash() != child.get_hash() || info.hash != child.get_hash() ||
+                info.reward != child.get_current_reward() || info.reward_signal != child.get_reward_signal() ||
+                info.is_terminal != child.is_terminal() || info.is_solution != child.is_solution()) {
+                std::cout << "Expand child error at step " << step << " for child " << i << "." << std::endl;
+                return false;
+            }
+        }
+        const RNDGameState &next = children[dist(gen)];
+        state = next.is_terminal() ? RNDGameState() : next;
+    }
+    std::cout << "Expand matches apply_action." << std::endl;
+    return true;
+}
+
+// Expand with a shared world update along random walks, checking each child against expand() byte for byte
+auto test_expand_shared(const GameParameters &params, const std::string &name) -> bool {
+    const RNDGameState start_state(params);
+    RNDGameState state = start_state;
+    std::vector<RNDGameState> children;
+    std::vector<RNDGameState> shared_children;
+    std::vector<ChildInfo> infos;
+    std::vector<ChildInfo> shared_infos;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> dist(0, kNumChildren - 1);
+    for (std::size_t step = 0; step < NUM_STEPS; ++step) {
+        expand(state, children, infos);
+        expand_shared(state, shared_children, shared_infos);
+        for (std::size_t i = 0; i < kNumChildren; ++i) {
+            const ChildInfo &info = infos[i];
+            const ChildInfo &shared_info = shared_infos[i];
+            if (shared_children[i].serialize() != children[i].serialize() ||
+                shared_children[i].get_changed_indices() != children[i].get_changed_indices() ||
+                shared_info.hash != info.hash || shared_info.reward != info.reward ||
+                shared_info.reward_signal != info.reward_signal || shared_info.is_terminal != info.is_terminal ||
+                shared_info.is_solution != info.is_solution) {
+                std::cout << "Shared expand child error on " << name << " at step " << step << " for child " << i
+                          << "." << std::endl;
+                return false;
+            }
+        }
+        const RNDGameState &next = children[dist(gen)];
+        state = next.is_terminal() ? start_state : next;
+    }
+    std::cout << "Shared expand matches expand on " << name << "." << std::endl;
+    return true;
+}
+
+auto test_expand_shared_levels() -> bool {
+    GameParameters board_params = kDefaultGameParams;
+    board_params["game_board_str"] = GameParameter(BOARD_STR);
+    GameParameters mixed_params = kDefaultGameParams;
+    mixed_params["game_board_str"] = GameParameter(MIXED_BOARD_STR);
+    mixed_params["blob_chance"] = GameParameter(64);
+    return test_expand_shared(kDefaultGameParams, "default board") &&
+           test_expand_shared(board_params, "gate board") && test_expand_shared(mixed_params, "mixed board");
+}
+
+auto test_expand_no_allocations() -> bool {
+    const RNDGameState state;
+    std::vector<RNDGameState> children;
+    std::vector<ChildInfo> infos;
+    expand(state, children, infos);
+    const std::size_t before = num_allocations.load();
+    expand(state, children, infos);
+    const std::size_t allocations = num_allocations.load() - before;
+    if (allocations != 0) {
+        std::cout << "Expand into reused children made " << allocations << " allocations." << std::endl;
+        return false;
+    }
+    std::cout << "Expand reuses child buffers." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_expand_matches_apply() && test_expand_shared_levels() && test_expand_no_allocations();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,90 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace stonesngems;
+
+constexpr std::size_t COMPARE_DEPTH = 8;
+
+auto test_serialize_local() -> bool {
+    RNDGameState state;
+    const RNDGameState start = state;
+    for (const auto action : {Action::kRight, Action::kDown, Action::kDown, Action::kLeft}) {
+        state.apply_action(action);
+    }
+    RNDGameState loaded = start;
+    loaded.deserialize_local(state.serialize_local());
+    // The per-step flags are cleared on load, so compare the full bytes after stepping both
+    const bool same_state = loaded == state && loaded.get_hash() == state.get_hash();
+    loaded.apply_action(Action::kNoop);
+    state.apply_action(Action::kNoop);
+    if (!same_state || loaded.serialize() != state.serialize()) {
+        std::cout << "serialize_local round trip error." << std::endl;
+        return false;
+    }
+    std::cout << "serialize_local round trip matches." << std::endl;
+    return true;
+}
+
+auto test_external_bfs_solve() -> bool {
+    const RNDGameState state = make_state(SMALL_BOARD_STR);
+    return check_solution(state, external_bfs_solve(state), "External BFS", SMALL_BOARD_SOLUTION_LENGTH);
+}
+
+// Small runs force several sorted runs per layer, which must merge to the same layers as the in-memory search
+auto test_external_bfs_matches_bfs() -> bool {
+    const RNDGameState state;
+    ExternalBFSOptions external_options;
+    external_options.run_memory_mb = 1;
+    external_options.max_depth = COMPARE_DEPTH;
+    BFSOptions options;
+    options.max_depth = COMPARE_DEPTH;
+    const SearchResult external = external_bfs_solve(state, external_options);
+    const SearchResult expected = bfs_solve(state, options);
+    if (external.solved != expected.solved || external.hit_limit != expected.hit_limit ||
+        external.nodes_expanded != expected.nodes_expanded || external.nodes_generated != expected.nodes_generated) {
+        std::cout << "External BFS expanded " << external.nodes_expanded << " nodes, expected "
+                  << expected.nodes_expanded << "." << std::endl;
+        return false;
+    }
+    std::cout << "External BFS matches BFS for " << COMPARE_DEPTH << " layers, " << external.nodes_expanded
+              << " nodes expanded." << std::endl;
+    return true;
+}
+
+auto test_external_bfs_cleanup() -> bool {
+    const std::filesystem::path work_dir = std::filesystem::temp_directory_path() / "sng_test_external_bfs";
+    std::filesystem::create_directories(work_dir);
+    ExternalBFSOptions options;
+    options.work_dir = work_dir.string();
+    options.max_depth = 2;
+    static_cast<void>(external_bfs_solve(RNDGameState(), options));
+    const bool empty = std::filesystem::is_empty(work_dir);
+    std::filesystem::remove_all(work_dir);
+    if (!empty) {
+        std::cout << "External BFS left files in the work directory." << std::endl;
+        return false;
+    }
+    options.run_memory_mb = 0;
+    try {
+        static_cast<void>(external_bfs_solve(RNDGameState(), options));
+        std::cout << "External BFS accepted zero run memory." << std::endl;
+        return false;
+    } catch (const std::invalid_argument &) {
+    }
+    std::cout << "External BFS cleans up its work directory." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_serialize_local() && test_external_bfs_solve() && test_external_bfs_matches_bfs() &&
+                        test_external_bfs_cleanup();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,99 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace stonesngems;
+
+constexpr int SMALL_BOARD_COLS = 6;
+
+// The small board with its step limit replaced
+auto small_board(int max_steps) -> RNDGameState {
+    const std::string unlimited = "5|6|-1";
+    return make_state("5|6|" + std::to_string(max_steps) + SMALL_BOARD_STR.substr(unlimited.size()));
+}
+
+// Manhattan distance from the agent to the exit, admissible as the agent moves one cell per step
+auto exit_distance(const RNDGameState &state) -> int {
+    std::vector<std::size_t> exits = state.get_indices(HiddenCellType::kExitClosed);
+    if (exits.empty()) {
+        exits = state.get_indices(HiddenCellType::kExitOpen);
+    }
+    const auto agent = static_cast<int>(state.get_agent_index());
+    const auto exit = static_cast<int>(exits.front());
+    return std::abs(agent / SMALL_BOARD_COLS - exit / SMALL_BOARD_COLS) +
+           std::abs(agent % SMALL_BOARD_COLS - exit % SMALL_BOARD_COLS);
+}
+
+auto test_hda_solve(std::size_t num_threads) -> bool {
+    const RNDGameState state = small_board(-1);
+    HDAOptions options;
+    options.num_threads = num_threads;
+    const std::string name = "HDA* with " + std::to_string(num_threads) + " threads";
+    if (!check_solution(state, hda_solve(state, options), name, SMALL_BOARD_SOLUTION_LENGTH)) {
+        return false;
+    }
+    options.heuristic = exit_distance;
+    return check_solution(state, hda_solve(state, options), name + " and heuristic", SMALL_BOARD_SOLUTION_LENGTH);
+}
+
+auto test_hda_greedy() -> bool {
+    const RNDGameState state = small_board(-1);
+    HDAOptions options;
+    options.num_threads = 2;
+    options.heuristic = exit_distance;
+    options.greedy = true;
+    return check_solution(state, hda_solve(state, options), "HDA* greedy", 0);
+}
+
+// Free noops revisit the same board with fewer steps remaining, which must never replace the faster path
+auto test_hda_step_limit() -> bool {
+    HDAOptions options;
+    options.num_threads = 2;
+    options.prune_actions = false;
+    options.cost = [](const RNDGameState &, Action action, const RNDGameState &) {
+        return action == Action::kNoop ? 0 : 1;
+    };
+    const int max_steps = static_cast<int>(SMALL_BOARD_SOLUTION_LENGTH) + 1;
+    const RNDGameState state = small_board(max_steps);
+    if (!check_solution(state, hda_solve(state, options), "HDA* with step limit", SMALL_BOARD_SOLUTION_LENGTH)) {
+        return false;
+    }
+    const RNDGameState short_state = small_board(max_steps - 1);
+    const SearchResult result = hda_solve(short_state, options);
+    if (result.solved || result.hit_limit) {
+        std::cout << "HDA* should not solve the level with too few steps." << std::endl;
+        return false;
+    }
+    std::cout << "HDA* respects the step limit." << std::endl;
+    return true;
+}
+
+auto test_hda_unsolvable() -> bool {
+    const RNDGameState state = make_state(UNSOLVABLE_BOARD_STR);
+    HDAOptions options;
+    options.num_threads = 3;
+    const SearchResult result = hda_solve(state, options);
+    if (result.solved || result.hit_limit || result.nodes_expanded == 0) {
+        std::cout << "HDA* should exhaust the unsolvable level." << std::endl;
+        return false;
+    }
+    options.max_expansions = 1;
+    if (!hda_solve(state, options).hit_limit) {
+        std::cout << "HDA* did not stop at the expansion limit." << std::endl;
+        return false;
+    }
+    std::cout << "HDA* exhausts unsolvable level." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_hda_solve(1) && test_hda_solve(3) && test_hda_greedy() && test_hda_step_limit() &&
+                        test_hda_unsolvable();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
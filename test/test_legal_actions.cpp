@@ -0,0 +1,180 @@
+#include <rnd/stonesngems.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace stonesngems;
+
+constexpr std::size_t NUM_STEPS = 1000;
+
+const std::string BOARD_STR =
+    "14|14|-1|1|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18|07|01|01|18|01|01|01|01|18|02|02|05|18|18|02|01|01|18|"
+    "02|02|02|02|18|02|32|01|18|18|01|01|02|36|02|02|02|01|18|01|01|02|18|18|18|18|18|18|01|01|01|01|18|34|18|18|"
+    "18|18|01|02|02|01|01|02|02|02|01|02|02|02|18|18|02|02|02|35|02|01|02|02|02|02|01|01|18|18|01|01|02|02|01|02|"
+    "02|01|02|02|01|01|18|18|02|02|02|01|02|01|01|02|01|01|02|02|18|18|18|18|18|18|00|02|01|01|18|18|18|18|18|18|"
+    "01|01|29|18|02|01|02|02|18|02|01|02|18|18|02|01|02|18|02|01|02|02|18|02|02|01|18|18|01|01|01|31|01|01|02|01|"
+    "28|01|38|02|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18";
+
+// Agent boxed in by steel above, a closed gate left, a stone against a wall right, and a stone below
+const std::string BOXED_BOARD_STR =
+    "5|5|-1|0|"
+    "19|19|19|19|19|"
+    "19|18|19|01|19|"
+    "19|27|00|03|19|"
+    "19|01|03|18|19|"
+    "19|19|19|19|19";
+
+// Falling stone two cells above the agent and a firefly diagonally below right
+const std::string HAZARD_BOARD_STR =
+    "6|5|-1|0|"
+    "19|19|19|19|19|"
+    "19|01|04|01|19|"
+    "19|01|01|01|19|"
+    "19|01|00|01|19|"
+    "19|01|01|12|19|"
+    "19|19|19|19|19";
+
+// Small level with magic walls, a blob, nuts, bombs, oranges, fireflies, butterflies and a gate
+const std::string MIXED_BOARD_STR =
+    "10|12|200|3|"
+    "19|19|19|19|19|19|19|19|19|19|19|19|"
+    "19|00|01|02|03|05|02|39|41|02|46|19|"
+    "19|02|03|01|01|02|01|01|01|10|01|19|"
+    "19|01|20|20|20|02|14|01|01|01|01|19|"
+    "19|01|01|01|01|02|01|03|03|05|02|19|"
+    "19|23|02|01|02|29|27|01|01|01|01|19|"
+    "19|02|01|40|01|02|18|41|02|01|44|19|"
+    "19|01|05|01|03|01|07|01|01|02|01|19|"
+    "19|02|01|02|01|02|01|01|43|01|01|19|"
+    "19|19|19|19|19|19|19|19|19|19|19|19";
+
+auto test_boxed_agent() -> bool {
+    GameParameters params = kDefaultGameParams;
+    params["game_board_str"] = GameParameter(BOXED_BOARD_STR);
+    const RNDGameState state(params);
+    if (state.legal_actions().size() != ALL_ACTIONS.size() ||
+        state.legal_actions(true) != std::vector<Action>{Action::kNoop}) {
+        std::cout << "Pruned legal actions error for boxed agent." << std::endl;
+        return false;
+    }
+    std::cout << "Boxed agent only has kNoop." << std::endl;
+    return true;
+}
+
+// Every pruned action must produce the same successor as kNoop
+auto test_pruned_actions(const GameParameters &params, const std::string &name, std::size_t &num_pruned) -> bool {
+    const RNDGameState start_state(params);
+    RNDGameState state = start_state;
+    std::vector<Action> actions;
+    std::mt19937 gen(0);
+    for (std::size_t step = 0; step < NUM_STEPS; ++step) {
+        state.legal_actions(actions, true);
+        RNDGameState noop_child = state;
+        noop_child.apply_action(Action::kNoop);
+        for (const auto action : ALL_ACTIONS) {
+            if (std::find(actions.begin(), actions.end(), action) != actions.end()) {
+                continue;
+            }
+            ++num_pruned;
+            RNDGameState child = state;
+            child.apply_action(action);
+            if (child.serialize() != noop_child.serialize()) {
+                std::cout << "Pruned action differs from kNoop on " << name << " at step " << step << "."
+                          << std::endl;
+                return false;
+            }
+        }
+        std::uniform_int_distribution<std::size_t> dist(0, actions.size() - 1);
+        state.apply_action(actions[dist(gen)]);
+        if (state.is_terminal()) {
+            state = start_state;
+        }
+    }
+    std::cout << "Pruned actions match kNoop on " << name << "." << std::endl;
+    return true;
+}
+
+auto test_pruned_actions_levels() -> bool {
+    GameParameters board_params = kDefaultGameParams;
+    board_params["game_board_str"] = GameParameter(BOARD_STR);
+    std::size_t num_pruned = 0;
+    const bool passed = test_pruned_actions(kDefaultGameParams, "default board", num_pruned) &&
+                        test_pruned_actions(board_params, "gate board", num_pruned);
+    if (passed && num_pruned == 0) {
+        std::cout << "No actions were pruned." << std::endl;
+        return false;
+    }
+    return passed;
+}
+
+auto test_fatal_hazards() -> bool {
+    GameParameters params = kDefaultGameParams;
+    params["game_board_str"] = GameParameter(HAZARD_BOARD_STR);
+    const RNDGameState state(params);
+    // Up walks under the falling stone, right and down walk next to the firefly
+    const std::vector<Action> expected_fatal{Action::kUp, Action::kRight, Action::kDown};
+    for (const auto action : ALL_ACTIONS) {
+        const bool expected = std::find(expected_fatal.begin(), expected_fatal.end(), action) != expected_fatal.end();
+        if (state.is_action_fatal(action) != expected) {
+            std::cout << "Fatal action error for action " << static_cast<int>(action) << "." << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Fatal hazards detected." << std::endl;
+    return true;
+}
+
+// Every action flagged as fatal must kill the agent
+auto test_fatal_actions(const GameParameters &params, const std::string &name, std::size_t &num_fatal) -> bool {
+    const RNDGameState start_state(params);
+    RNDGameState state = start_state;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> dist(0, ALL_ACTIONS.size() - 1);
+    for (std::size_t step = 0; step < NUM_STEPS; ++step) {
+        for (const auto action : ALL_ACTIONS) {
+            if (!state.is_action_fatal(action)) {
+                continue;
+            }
+            ++num_fatal;
+            RNDGameState child = state;
+            child.apply_action(action);
+            if (child.get_agent_pos() != kAgentPosDie) {
+                std::cout << "Fatal action survived on " << name << " at step " << step << "." << std::endl;
+                return false;
+            }
+        }
+        state.apply_action(ALL_ACTIONS[dist(gen)]);    // NOLINT(*-bounds-constant-array-index)
+        if (state.is_terminal()) {
+            state = start_state;
+        }
+    }
+    std::cout << "Fatal actions kill the agent on " << name << "." << std::endl;
+    return true;
+}
+
+auto test_fatal_actions_levels() -> bool {
+    GameParameters mixed_params = kDefaultGameParams;
+    mixed_params["game_board_str"] = GameParameter(MIXED_BOARD_STR);
+    GameParameters hazard_params = kDefaultGameParams;
+    hazard_params["game_board_str"] = GameParameter(HAZARD_BOARD_STR);
+    std::size_t num_fatal = 0;
+    const bool passed = test_fatal_actions(kDefaultGameParams, "default board", num_fatal) &&
+                        test_fatal_actions(mixed_params, "mixed board", num_fatal) &&
+                        test_fatal_actions(hazard_params, "hazard board", num_fatal);
+    if (passed && num_fatal == 0) {
+        std::cout << "No actions were flagged as fatal." << std::endl;
+        return false;
+    }
+    return passed;
+}
+
+int main() {
+    const bool passed = test_boxed_agent() && test_pruned_actions_levels() && test_fatal_hazards() &&
+                        test_fatal_actions_levels();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
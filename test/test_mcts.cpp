@@ -0,0 +1,123 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace stonesngems;
+
+constexpr std::size_t NUM_SIMULATIONS = 300;
+constexpr std::size_t MAX_STEPS = 50;
+
+auto test_mcts_solve(std::size_t num_threads) -> bool {
+    const RNDGameState state = make_state(SMALL_BOARD_STR);
+    MCTSOptions options;
+    options.num_threads = num_threads;
+    options.num_simulations = NUM_SIMULATIONS;
+    const SearchResult result = mcts_solve(state, options, MAX_STEPS);
+    RNDGameState replay = state;
+    for (const auto action : result.solution) {
+        replay.apply_action(action);
+    }
+    if (!result.solved || !replay.is_solution()) {
+        std::cout << "MCTS with " << num_threads << " threads did not solve the small level." << std::endl;
+        return false;
+    }
+    // The search that reaches the solution stops early, so not every call runs all of its simulations
+    if (result.nodes_expanded == 0 || result.nodes_expanded > NUM_SIMULATIONS * result.solution.size()) {
+        std::cout << "MCTS with " << num_threads << " threads counted " << result.nodes_expanded << " simulations."
+                  << std::endl;
+        return false;
+    }
+    std::cout << "MCTS with " << num_threads << " threads solved in " << result.solution.size() << " steps."
+              << std::endl;
+    return true;
+}
+
+// States which are not stored are replayed from an ancestor, which must give the same tree as storing all of them
+auto test_mcts_state_interval() -> bool {
+    const RNDGameState state;
+    MCTSOptions options;
+    options.num_simulations = NUM_SIMULATIONS;
+    options.state_interval = 1;
+    MCTS all_stored(options);
+    options.state_interval = 5;
+    MCTS replayed(options);
+    all_stored.set_root(state);
+    replayed.set_root(state);
+    all_stored.search();
+    replayed.search();
+    if (all_stored.root_policy() != replayed.root_policy() || all_stored.root_value() != replayed.root_value() ||
+        all_stored.num_nodes() != replayed.num_nodes()) {
+        std::cout << "MCTS tree depends on the state interval." << std::endl;
+        return false;
+    }
+    std::cout << "MCTS replayed states match stored states." << std::endl;
+    return true;
+}
+
+auto test_mcts_evaluate() -> bool {
+    const RNDGameState state = make_state(SMALL_BOARD_STR);
+    MCTSOptions options;
+    options.num_threads = 2;
+    options.num_simulations = NUM_SIMULATIONS;
+    options.stop_on_solution = false;
+    options.evaluate = [](const RNDGameState &, Evaluation &evaluation) {
+        evaluation.priors.fill(0);
+        evaluation.priors[static_cast<std::size_t>(Action::kRight)] = 1;
+        evaluation.value = 0;
+    };
+    MCTS tree(options);
+    tree.set_root(state);
+    tree.search();
+    const auto policy = tree.root_policy();
+    const float total = std::accumulate(policy.begin(), policy.end(), 0.0F);
+    if (tree.best_action() != Action::kRight || total < 0.99F || total > 1.01F ||
+        tree.num_simulations() != NUM_SIMULATIONS) {
+        std::cout << "MCTS did not follow the prior callback." << std::endl;
+        return false;
+    }
+    // Advancing keeps the subtree, and the new root holds the state after the action
+    const std::size_t num_nodes = tree.num_nodes();
+    tree.advance(Action::kRight);
+    RNDGameState expected = state;
+    expected.apply_action(Action::kRight);
+    if (tree.num_nodes() != num_nodes || tree.root_state() != expected || tree.root_value() == 0) {
+        std::cout << "MCTS advance did not keep the subtree." << std::endl;
+        return false;
+    }
+    std::cout << "MCTS follows the prior callback and keeps the subtree on advance." << std::endl;
+    return true;
+}
+
+auto test_mcts_errors() -> bool {
+    MCTSOptions options;
+    options.state_interval = 0;
+    try {
+        const MCTS tree(options);
+        std::cout << "MCTS accepted a state interval of 0." << std::endl;
+        return false;
+    } catch (const std::invalid_argument &) {
+    }
+    MCTS tree;
+    try {
+        tree.search();
+        std::cout << "MCTS searched without a root." << std::endl;
+        return false;
+    } catch (const std::logic_error &) {
+    }
+    std::cout << "MCTS errors handled." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_mcts_solve(1) && test_mcts_solve(3) && test_mcts_state_interval() &&
+                        test_mcts_evaluate() && test_mcts_errors();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
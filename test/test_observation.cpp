@@ -0,0 +1,168 @@
+#include <rnd/stonesngems.h>
+
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace stonesngems;
+
+constexpr std::size_t NUM_STEPS = 1000;
+
+const std::string BOARD_STR =
+    "14|14|-1|1|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18|07|01|01|18|01|01|01|01|18|02|02|05|18|18|02|01|01|18|"
+    "02|02|02|02|18|02|32|01|18|18|01|01|02|36|02|02|02|01|18|01|01|02|18|18|18|18|18|18|01|01|01|01|18|34|18|18|"
+    "18|18|01|02|02|01|01|02|02|02|01|02|02|02|18|18|02|02|02|35|02|01|02|02|02|02|01|01|18|18|01|01|02|02|01|02|"
+    "02|01|02|02|01|01|18|18|02|02|02|01|02|01|01|02|01|01|02|02|18|18|18|18|18|18|00|02|01|01|18|18|18|18|18|18|"
+    "01|01|29|18|02|01|02|02|18|02|01|02|18|18|02|01|02|18|02|01|02|02|18|02|02|01|18|18|01|01|01|31|01|01|02|01|"
+    "28|01|38|02|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18";
+
+auto test_update_observation(const std::string &board_str) -> bool {
+    GameParameters params = kDefaultGameParams;
+    params["game_board_str"] = GameParameter(board_str);
+    RNDGameState state(params);
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> dist(0, RNDGameState::action_space_size() - 1);
+    std::vector<float> obs = state.get_observation();
+    for (std::size_t i = 0; i < NUM_STEPS; ++i) {
+        if (state.is_terminal()) {
+            state.reset();
+            state.get_observation(obs);
+        }
+        state.apply_action(ALL_ACTIONS[dist(gen)]);    // NOLINT(*-bounds-constant-array-index)
+        state.update_observation(obs);
+        if (obs != state.get_observation()) {
+            std::cout << "update_observation error at step " << i << "." << std::endl;
+            return false;
+        }
+    }
+    std::cout << "update_observation matches get_observation." << std::endl;
+    return true;
+}
+
+auto test_observation_batch() -> bool {
+    constexpr std::size_t BATCH_SIZE = 37;
+    const GameParameters params = kDefaultGameParams;
+    std::vector<RNDGameState> states;
+    RNDGameState state(params);
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+        states.push_back(state);
+        state.apply_action(ALL_ACTIONS[i % RNDGameState::action_space_size()]);    // NOLINT(*-bounds-constant-array-index)
+    }
+    const std::size_t obs_size = state.get_observation().size();
+    const std::size_t packed_size = state.packed_observation_size();
+    ThreadPool pool(3);
+    for (ThreadPool *p : {static_cast<ThreadPool *>(nullptr), &pool}) {
+        std::vector<float> batch_float(BATCH_SIZE * obs_size, -1);
+        std::vector<uint8_t> batch_byte(BATCH_SIZE * obs_size, 2);
+        std::vector<uint8_t> batch_packed(BATCH_SIZE * packed_size, 0xFF);    // NOLINT(*-magic-numbers)
+        get_observation_batch(states.data(), BATCH_SIZE, batch_float.data(), p);
+        get_observation_batch(states.data(), BATCH_SIZE, batch_byte.data(), p);
+        get_observation_batch_packed(states.data(), BATCH_SIZE, batch_packed.data(), p);
+        for (std::size_t n = 0; n < BATCH_SIZE; ++n) {
+            const std::vector<float> obs = states[n].get_observation();
+            for (std::size_t i = 0; i < obs_size; ++i) {
+                const std::size_t bit = n * packed_size * CHAR_BIT + i;
+                const auto packed_value = static_cast<float>((batch_packed[bit / CHAR_BIT] >> (bit % CHAR_BIT)) & 1);
+                if (batch_float[n * obs_size + i] != obs[i] ||
+                    static_cast<float>(batch_byte[n * obs_size + i]) != obs[i] || packed_value != obs[i]) {
+                    std::cout << "get_observation_batch error for state " << n << "." << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    std::cout << "get_observation_batch matches get_observation." << std::endl;
+    return true;
+}
+
+auto test_observation_spec() -> bool {
+    const std::vector<VisibleCellType> filter_elements{VisibleCellType::kAgent, VisibleCellType::kStone,
+                                                       VisibleCellType::kDiamond, VisibleCellType::kExitClosed,
+                                                       VisibleCellType::kStone};
+    const ObservationSpec spec(filter_elements);
+    const GameParameters params = kDefaultGameParams;
+    RNDGameState state(params);
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<std::size_t> dist(0, RNDGameState::action_space_size() - 1);
+    std::vector<float> obs = state.get_observation(spec);
+    for (std::size_t i = 0; i < NUM_STEPS; ++i) {
+        if (state.is_terminal()) {
+            state.reset();
+            state.get_observation(spec, obs);
+        }
+        state.apply_action(ALL_ACTIONS[dist(gen)]);    // NOLINT(*-bounds-constant-array-index)
+        state.update_observation(spec, obs);
+        // Filtered channels should match the corresponding full channels, duplicates left empty
+        const std::vector<float> full_obs = state.get_observation();
+        const auto shape = state.observation_shape(spec);
+        const std::size_t channel_length = shape[1] * shape[2];
+        for (std::size_t c = 0; c < shape[0]; ++c) {
+            const bool is_duplicate = c == filter_elements.size() - 1;
+            const auto full_channel = static_cast<std::size_t>(filter_elements[c]);
+            for (std::size_t j = 0; j < channel_length; ++j) {
+                const float expected = is_duplicate ? 0 : full_obs[full_channel * channel_length + j];
+                if (obs[c * channel_length + j] != expected) {
+                    std::cout << "filtered observation error at step " << i << "." << std::endl;
+                    return false;
+                }
+            }
+        }
+        if (obs != state.get_observation(filter_elements)) {
+            std::cout << "filtered observation error at step " << i << "." << std::endl;
+            return false;
+        }
+    }
+    std::cout << "filtered observations match get_observation." << std::endl;
+    return true;
+}
+
+auto test_cropped_observation(std::size_t window_rows, std::size_t window_cols) -> bool {
+    const GameParameters params = kDefaultGameParams;
+    RNDGameState state(params);
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<std::size_t> dist(0, RNDGameState::action_space_size() - 1);
+    const VisibleCellType padding = VisibleCellType::kWallSteel;
+    for (std::size_t i = 0; i < NUM_STEPS; ++i) {
+        if (state.is_terminal()) {
+            state.reset();
+        }
+        state.apply_action(ALL_ACTIONS[dist(gen)]);    // NOLINT(*-bounds-constant-array-index)
+        const std::vector<float> full_obs = state.get_observation();
+        const std::vector<float> obs = state.get_cropped_observation(window_rows, window_cols, padding);
+        const std::vector<int8_t> ids = state.get_cropped_observation_ids(window_rows, window_cols, padding);
+        const auto shape = state.observation_shape();
+        const auto [agent_row, agent_col] = state.index_to_position(state.get_agent_index());
+        for (std::size_t r = 0; r < window_rows; ++r) {
+            for (std::size_t c = 0; c < window_cols; ++c) {
+                // Wraps around for negative board positions, which then fails the bounds check
+                const RNDGameState::Position pos{agent_row + r - window_rows / 2, agent_col + c - window_cols / 2};
+                const std::size_t window_idx = r * window_cols + c;
+                for (std::size_t channel = 0; channel < shape[0]; ++channel) {
+                    const float expected =
+                        state.is_pos_in_bounds(pos)
+                            ? full_obs[channel * shape[1] * shape[2] + state.position_to_index(pos)]
+                            : static_cast<float>(channel == static_cast<std::size_t>(padding));
+                    const float value = obs[channel * window_rows * window_cols + window_idx];
+                    if (value != expected || (value == 1 && static_cast<std::size_t>(ids[window_idx]) != channel)) {
+                        std::cout << "cropped observation error at step " << i << "." << std::endl;
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    std::cout << "cropped observations match get_observation for " << window_rows << "x" << window_cols << "."
+              << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_update_observation(DEFAULT_GAME_BOARD_STR) && test_update_observation(BOARD_STR) &&
+                        test_observation_batch() && test_observation_spec() && test_cropped_observation(15, 15) &&
+                        test_cropped_observation(4, 7) && test_cropped_observation(30, 50);    // NOLINT
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
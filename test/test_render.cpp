@@ -0,0 +1,142 @@
+#include <rnd/stonesngems.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace stonesngems;
+
+constexpr std::size_t NUM_STEPS = 200;
+
+// Reference per-pixel rendering from the sprite atlas
+auto render_reference(const RNDGameState &state, std::size_t tile_size = SPRITE_WIDTH) -> std::vector<uint8_t> {
+    const auto shape = state.image_shape(tile_size);
+    const std::size_t rows = shape[0] / tile_size;
+    const std::size_t cols = shape[1] / tile_size;
+    const std::vector<float> obs = state.get_observation();
+    std::vector<uint8_t> img(shape[0] * shape[1] * shape[2], 0);
+    for (std::size_t i = 0; i < rows * cols; ++i) {
+        std::size_t element = 0;
+        while (obs[element * rows * cols + i] == 0) {
+            ++element;
+        }
+        const uint8_t *sprite = get_sprite(static_cast<VisibleCellType>(element), tile_size);
+        const std::size_t h = i / cols;
+        const std::size_t w = i % cols;
+        const std::size_t sprite_row_len = tile_size * SPRITE_CHANNELS;
+        for (std::size_t r = 0; r < tile_size; ++r) {
+            for (std::size_t c = 0; c < sprite_row_len; ++c) {
+                img[(h * tile_size + r) * shape[1] * SPRITE_CHANNELS + w * sprite_row_len + c] =
+                    sprite[r * sprite_row_len + c];
+            }
+        }
+    }
+    return img;
+}
+
+auto test_to_image() -> bool {
+    RNDGameState state(kDefaultGameParams);
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> dist(0, RNDGameState::action_space_size() - 1);
+    std::vector<uint8_t> img;
+    for (std::size_t i = 0; i < NUM_STEPS; ++i) {
+        if (state.is_terminal()) {
+            state.reset();
+        }
+        state.to_image(img);
+        if (img != render_reference(state) || img != state.to_image()) {
+            std::cout << "to_image error at step " << i << "." << std::endl;
+            return false;
+        }
+        state.apply_action(ALL_ACTIONS[dist(gen)]);    // NOLINT(*-bounds-constant-array-index)
+    }
+    std::cout << "to_image matches reference rendering." << std::endl;
+    return true;
+}
+
+auto test_frame_buffer() -> bool {
+    RNDGameState state(kDefaultGameParams);
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> dist(0, RNDGameState::action_space_size() - 1);
+    FrameBuffer frame_buffer(state);
+    FrameBuffer external_frame_buffer;
+    std::vector<uint8_t> external_img(state.to_image().size());
+    const std::size_t num_tiles = external_img.size() / SPRITE_DATA_LEN;
+    for (std::size_t i = 0; i < NUM_STEPS; ++i) {
+        if (state.is_terminal()) {
+            state.reset();
+        }
+        const std::vector<uint8_t> img = state.to_image();
+        external_frame_buffer.render(state, external_img.data());
+        if (frame_buffer.render(state) != img || external_img != img) {
+            std::cout << "FrameBuffer error at step " << i << "." << std::endl;
+            return false;
+        }
+        if (i > 0 && frame_buffer.num_tiles_drawn() == num_tiles) {
+            std::cout << "FrameBuffer repainted every tile at step " << i << "." << std::endl;
+            return false;
+        }
+        state.apply_action(ALL_ACTIONS[dist(gen)]);    // NOLINT(*-bounds-constant-array-index)
+    }
+    frame_buffer.invalidate();
+    frame_buffer.render(state);
+    if (frame_buffer.num_tiles_drawn() != num_tiles) {
+        std::cout << "FrameBuffer did not repaint after invalidate." << std::endl;
+        return false;
+    }
+    std::cout << "FrameBuffer matches to_image." << std::endl;
+    return true;
+}
+
+auto test_tile_sizes() -> bool {
+    RNDGameState state(kDefaultGameParams);
+    const std::vector<uint8_t> full_img = state.to_image();
+    if (state.to_image(SPRITE_WIDTH) != full_img) {
+        std::cout << "Native tile size differs from to_image." << std::endl;
+        return false;
+    }
+    const std::size_t full_cols = state.image_shape()[1];
+    for (const std::size_t tile_size : SPRITE_TILE_SIZES) {
+        const std::vector<uint8_t> img = state.to_image(tile_size);
+        if (img != render_reference(state, tile_size) || FrameBuffer(state, tile_size).frame() != img) {
+            std::cout << "Tile size " << tile_size << " rendering error." << std::endl;
+            return false;
+        }
+        // Downsampled sprites should be an area average of the native sprites
+        const auto shape = state.image_shape(tile_size);
+        const std::size_t factor = SPRITE_WIDTH / tile_size;
+        for (std::size_t i = 0; i < img.size(); ++i) {
+            const std::size_t h = i / (shape[1] * shape[2]);
+            const std::size_t w = (i / shape[2]) % shape[1];
+            const std::size_t c = i % shape[2];
+            std::size_t total = 0;
+            for (std::size_t dh = 0; dh < factor; ++dh) {
+                for (std::size_t dw = 0; dw < factor; ++dw) {
+                    total += full_img[((h * factor + dh) * full_cols + (w * factor + dw)) * shape[2] + c];
+                }
+            }
+            const auto mean = static_cast<float>(total) / static_cast<float>(factor * factor);
+            if (std::abs(mean - static_cast<float>(img[i])) > 1) {
+                std::cout << "Tile size " << tile_size << " is not an area average of the native sprites." << std::endl;
+                return false;
+            }
+        }
+    }
+    try {
+        [[maybe_unused]] const auto img = state.to_image(SPRITE_WIDTH + 1);
+        std::cout << "Invalid tile size did not throw." << std::endl;
+        return false;
+    } catch (const std::invalid_argument &) {
+    }
+    std::cout << "Tile sizes match reference rendering." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_to_image() && test_frame_buffer() && test_tile_sizes();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,85 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#define SNG_TEST_COUNT_ALLOCATIONS
+#include "test_util.h"
+
+using namespace stonesngems;
+
+constexpr std::size_t NUM_PLAYOUTS = 200;
+
+auto same_stats(const RolloutStats &lhs, const RolloutStats &rhs) -> bool {
+    return lhs.num_playouts == rhs.num_playouts && lhs.num_solved == rhs.num_solved &&
+           lhs.num_terminal == rhs.num_terminal && lhs.total_return == rhs.total_return &&
+           lhs.max_return == rhs.max_return && lhs.total_depth == rhs.total_depth;
+}
+
+// Playouts are seeded by their index, so the statistics do not depend on the number of threads
+auto test_rollout_threads() -> bool {
+    const RNDGameState state;
+    RolloutOptions options;
+    options.num_playouts = NUM_PLAYOUTS;
+    for (const auto policy : {RolloutPolicy::kUniform, RolloutPolicy::kPruned, RolloutPolicy::kSafe}) {
+        options.policy = policy;
+        RolloutEngine single(1);
+        RolloutEngine multi(3);
+        const RolloutStats expected = single.run(state, options);
+        if (!same_stats(expected, multi.run(state, options)) || expected.num_playouts != NUM_PLAYOUTS ||
+            expected.mean_depth() > static_cast<double>(options.max_depth)) {
+            std::cout << "Rollout statistics differ between thread counts." << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Rollout statistics match across thread counts." << std::endl;
+    return true;
+}
+
+auto test_rollout_policies() -> bool {
+    const RNDGameState state = make_state(SMALL_BOARD_STR);
+    RolloutEngine engine;
+    RolloutOptions options;
+    options.num_playouts = NUM_PLAYOUTS;
+    options.policy = RolloutPolicy::kSafe;
+    const RolloutStats stats = engine.run(state, options);
+    if (stats.num_solved == 0 || stats.solve_rate() > 1 || stats.max_return <= 0 ||
+        stats.num_terminal < stats.num_solved) {
+        std::cout << "Safe rollouts never solved the small level." << std::endl;
+        return false;
+    }
+    options.seed = 1;
+    if (same_stats(stats, engine.run(state, options))) {
+        std::cout << "Rollout seed had no effect." << std::endl;
+        return false;
+    }
+    std::cout << "Safe rollouts solve the small level at rate " << stats.solve_rate() << ", mean depth "
+              << stats.mean_depth() << "." << std::endl;
+    return true;
+}
+
+// Once the scratch state holds the level, repeating the same playouts must not allocate
+auto test_rollout_allocations() -> bool {
+    const RNDGameState state;
+    RolloutEngine engine;
+    RolloutOptions options;
+    options.num_playouts = NUM_PLAYOUTS;
+    options.policy = RolloutPolicy::kSafe;
+    static_cast<void>(engine.run(state, options));
+    const std::size_t before = num_allocations.load();
+    static_cast<void>(engine.run(state, options));
+    const std::size_t allocations = num_allocations.load() - before;
+    if (allocations != 0) {
+        std::cout << "Rollouts allocated " << allocations << " times." << std::endl;
+        return false;
+    }
+    std::cout << "Rollouts reuse the scratch state without allocating." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_rollout_threads() && test_rollout_policies() && test_rollout_allocations();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
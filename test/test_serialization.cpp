@@ -31,6 +31,16 @@ void test_serialization() {
     }
     std::cout << state_copy << std::endl;
     std::cout << state_copy.get_hash() << std::endl;
+
+    // The changed cells of the last step are not serialized, and stepping the copy matches the original
+    if (!state_copy.get_changed_indices().empty()) {
+        std::cout << "serialization error, changed cells restored." << std::endl;
+    }
+    state.apply_action(Action::kDown);
+    state_copy.apply_action(Action::kDown);
+    if (state != state_copy || state.get_changed_indices() != state_copy.get_changed_indices()) {
+        std::cout << "serialization error, step after deserializing differs." << std::endl;
+    }
 }
 
 int main() {
@@ -0,0 +1,71 @@
+#include <rnd/stonesngems.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace stonesngems;
+
+using std::chrono::duration;
+using std::chrono::high_resolution_clock;
+using std::chrono::milliseconds;
+
+constexpr std::size_t BATCH_SIZE = 256;
+constexpr std::size_t NUM_BATCHES = 200;
+constexpr std::size_t MILLISECONDS_PER_SECOND = 1000;
+
+template <typename F>
+void time_batches(const std::string &name, F &&func) {
+    const auto t1 = high_resolution_clock::now();
+    for (std::size_t i = 0; i < NUM_BATCHES; ++i) {
+        func();
+    }
+    const auto t2 = high_resolution_clock::now();
+    const duration<double, std::milli> ms_double = t2 - t1;
+    std::cout << name << ": total time for " << NUM_BATCHES << " batches of " << BATCH_SIZE << ": "
+              << ms_double.count() / MILLISECONDS_PER_SECOND << ", time per batch: "
+              << ms_double.count() / MILLISECONDS_PER_SECOND / NUM_BATCHES << std::endl;
+}
+
+void test_speed_batch() {
+    const GameParameters params = kDefaultGameParams;
+    std::vector<RNDGameState> states;
+    states.reserve(BATCH_SIZE);
+    RNDGameState state(params);
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+        states.push_back(state);
+        state.apply_action(ALL_ACTIONS[i % RNDGameState::action_space_size()]);    // NOLINT(*-bounds-constant-array-index)
+    }
+    const auto shape = state.observation_shape();
+    const std::size_t obs_size = shape[0] * shape[1] * shape[2];
+    std::vector<float> batch_float(BATCH_SIZE * obs_size);
+    std::vector<uint8_t> batch_byte(BATCH_SIZE * obs_size);
+    std::vector<uint8_t> batch_packed(BATCH_SIZE * state.packed_observation_size());
+    ThreadPool pool(std::thread::hardware_concurrency());
+
+    std::cout << "starting ..." << std::endl;
+
+    time_batches("get_observation + copy", [&]() {
+        for (std::size_t n = 0; n < BATCH_SIZE; ++n) {
+            const std::vector<float> obs = states[n].get_observation();
+            std::copy(obs.begin(), obs.end(), batch_float.begin() + static_cast<std::ptrdiff_t>(n * obs_size));
+        }
+    });
+    time_batches("batch float", [&]() { get_observation_batch(states.data(), BATCH_SIZE, batch_float.data()); });
+    time_batches("batch byte", [&]() { get_observation_batch(states.data(), BATCH_SIZE, batch_byte.data()); });
+    time_batches("batch packed",
+                 [&]() { get_observation_batch_packed(states.data(), BATCH_SIZE, batch_packed.data()); });
+    std::cout << "Using " << pool.num_threads() << " threads" << std::endl;
+    time_batches("batch float threaded",
+                 [&]() { get_observation_batch(states.data(), BATCH_SIZE, batch_float.data(), &pool); });
+    time_batches("batch byte threaded",
+                 [&]() { get_observation_batch(states.data(), BATCH_SIZE, batch_byte.data(), &pool); });
+    time_batches("batch packed threaded",
+                 [&]() { get_observation_batch_packed(states.data(), BATCH_SIZE, batch_packed.data(), &pool); });
+}
+
+int main() {
+    test_speed_batch();
+}
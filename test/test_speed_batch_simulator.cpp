@@ -0,0 +1,71 @@
+#include <rnd/stonesngems.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace stonesngems;
+
+using std::chrono::duration;
+using std::chrono::high_resolution_clock;
+using std::chrono::milliseconds;
+
+constexpr std::size_t NUM_INSTANCES = 256;
+constexpr std::size_t NUM_STEPS = 2000;
+constexpr std::size_t MILLISECONDS_PER_SECOND = 1000;
+
+// Both runs draw the same actions, so they step the same boards
+void draw_actions(std::mt19937 &gen, std::vector<Action> &actions) {
+    std::uniform_int_distribution<std::size_t> dist(0, RNDGameState::action_space_size() - 1);
+    for (auto &action : actions) {
+        action = ALL_ACTIONS[dist(gen)];    // NOLINT(*-bounds-constant-array-index)
+    }
+}
+
+void report(const std::string &name, duration<double, std::milli> ms_double) {
+    std::cout << name << ": total time for " << NUM_STEPS << " steps of " << NUM_INSTANCES
+              << " instances: " << ms_double.count() / MILLISECONDS_PER_SECOND << ", time per instance step: "
+              << ms_double.count() / MILLISECONDS_PER_SECOND / (NUM_STEPS * NUM_INSTANCES) << std::endl;
+}
+
+void test_speed_batch_simulator() {
+    const RNDGameState state;
+    std::vector<Action> actions(NUM_INSTANCES);
+
+    std::cout << "starting ..." << std::endl;
+
+    std::vector<RNDGameState> states(NUM_INSTANCES, state);
+    std::mt19937 gen(0);
+    auto t1 = high_resolution_clock::now();
+    for (std::size_t step = 0; step < NUM_STEPS; ++step) {
+        draw_actions(gen, actions);
+        for (std::size_t i = 0; i < NUM_INSTANCES; ++i) {
+            states[i].apply_action(actions[i]);
+        }
+    }
+    auto t2 = high_resolution_clock::now();
+    report("apply_action per state", t2 - t1);
+
+    BatchSimulator sim(state, NUM_INSTANCES);
+    gen.seed(0);
+    t1 = high_resolution_clock::now();
+    for (std::size_t step = 0; step < NUM_STEPS; ++step) {
+        draw_actions(gen, actions);
+        sim.step(actions);
+    }
+    t2 = high_resolution_clock::now();
+    report("BatchSimulator", t2 - t1);
+
+    uint64_t mismatches = 0;
+    for (std::size_t i = 0; i < NUM_INSTANCES; ++i) {
+        mismatches += static_cast<uint64_t>(sim.get_hash(i) != states[i].get_hash());
+    }
+    std::cout << "Instances differing from the per state run: " << mismatches << std::endl;
+}
+
+int main() {
+    test_speed_batch_simulator();
+}
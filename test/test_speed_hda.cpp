@@ -0,0 +1,49 @@
+#include <rnd/stonesngems.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace stonesngems;
+
+#ifndef SNG_LEVELS_FILE
+#define SNG_LEVELS_FILE "bd_levels/bd_levels.txt"
+#endif
+
+constexpr std::size_t MAX_EXPANSIONS = 50000;
+
+// Expand a fixed number of nodes on the first bd level, doubling the thread count up to the hardware concurrency
+void test_speed_hda() {
+    std::ifstream file(SNG_LEVELS_FILE);
+    std::string board_str;
+    std::getline(file, board_str);
+    GameParameters params = kDefaultGameParams;
+    if (!board_str.empty()) {
+        params["game_board_str"] = GameParameter(board_str);
+    }
+    const RNDGameState state(params);
+    const std::size_t max_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+    std::cout << "starting ..." << std::endl;
+    HDAOptions options;
+    options.max_expansions = MAX_EXPANSIONS;
+    double base_rate = 0;
+    for (std::size_t num_threads = 1;; num_threads = std::min(num_threads * 2, max_threads)) {
+        options.num_threads = num_threads;
+        const SearchResult result = hda_solve(state, options);
+        const double rate = result.nodes_per_second();
+        base_rate = (num_threads == 1) ? rate : base_rate;
+        std::cout << num_threads << " threads: expanded " << result.nodes_expanded << " in " << result.seconds
+                  << " s, " << rate << " nodes/s, speedup " << (base_rate > 0 ? rate / base_rate : 0) << std::endl;
+        if (num_threads == max_threads) {
+            break;
+        }
+    }
+}
+
+int main() {
+    test_speed_hda();
+}
@@ -1,7 +1,9 @@
 #include <rnd/stonesngems.h>
 
 #include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
 using namespace stonesngems;
 
@@ -12,16 +14,17 @@ using std::chrono::milliseconds;
 constexpr std::size_t NUM_STEPS = 1000000;
 constexpr std::size_t MILLISECONDS_PER_SECOND = 1000;
 
+const std::string BOARD_STR =
+    "14|14|-1|1|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18|07|01|01|18|01|01|01|01|18|02|02|05|18|18|02|01|01|18|"
+    "02|02|02|02|18|02|32|01|18|18|01|01|02|36|02|02|02|01|18|01|01|02|18|18|18|18|18|18|01|01|01|01|18|34|18|18|"
+    "18|18|01|02|02|01|01|02|02|02|01|02|02|02|18|18|02|02|02|35|02|01|02|02|02|02|01|01|18|18|01|01|02|02|01|02|"
+    "02|01|02|02|01|01|18|18|02|02|02|01|02|01|01|02|01|01|02|02|18|18|18|18|18|18|00|02|01|01|18|18|18|18|18|18|"
+    "01|01|29|18|02|01|02|02|18|02|01|02|18|18|02|01|02|18|02|01|02|02|18|02|02|01|18|18|01|01|01|31|01|01|02|01|"
+    "28|01|38|02|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18";
+
 void test_throughput() {
-    const std::string board_str =
-        "14|14|-1|1|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18|07|01|01|18|01|01|01|01|18|02|02|05|18|18|02|01|01|18|"
-        "02|02|02|02|18|02|32|01|18|18|01|01|02|36|02|02|02|01|18|01|01|02|18|18|18|18|18|18|01|01|01|01|18|34|18|18|"
-        "18|18|01|02|02|01|01|02|02|02|01|02|02|02|18|18|02|02|02|35|02|01|02|02|02|02|01|01|18|18|01|01|02|02|01|02|"
-        "02|01|02|02|01|01|18|18|02|02|02|01|02|01|01|02|01|01|02|02|18|18|18|18|18|18|00|02|01|01|18|18|18|18|18|18|"
-        "01|01|29|18|02|01|02|02|18|02|01|02|18|18|02|01|02|18|02|01|02|02|18|02|02|01|18|18|01|01|01|31|01|01|02|01|"
-        "28|01|38|02|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18";
     GameParameters params = kDefaultGameParams;
-    params["game_board_str"] = GameParameter(board_str);
+    params["game_board_str"] = GameParameter(BOARD_STR);
     const RNDGameState state(params);
     std::vector<RNDGameState> state_list;
 
@@ -50,6 +53,33 @@ void test_throughput() {
     std::cout << "Time per step :  " << ms_double.count() / MILLISECONDS_PER_SECOND / NUM_STEPS << std::endl;
 }
 
+// Same expansion loop, writing the children into reused states
+void test_throughput_expand() {
+    GameParameters params = kDefaultGameParams;
+    params["game_board_str"] = GameParameter(BOARD_STR);
+    const RNDGameState state(params);
+    std::vector<RNDGameState> children;
+    std::vector<ChildInfo> infos;
+
+    std::cout << "starting expand ..." << std::endl;
+
+    auto t1 = high_resolution_clock::now();
+    for (std::size_t i = 0; i < NUM_STEPS; ++i) {
+        expand(state, children, infos);
+        const std::vector<float> obs = state.get_observation();
+        (void)obs;
+        const uint64_t hash = state.get_hash();
+        (void)hash;
+    }
+    const auto t2 = high_resolution_clock::now();
+    const duration<double, std::milli> ms_double = t2 - t1;
+
+    std::cout << "Total time for " << NUM_STEPS << " steps: " << ms_double.count() / MILLISECONDS_PER_SECOND
+              << std::endl;
+    std::cout << "Time per step :  " << ms_double.count() / MILLISECONDS_PER_SECOND / NUM_STEPS << std::endl;
+}
+
 int main() {
     test_throughput();
+    test_throughput_expand();
 }
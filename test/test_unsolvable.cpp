@@ -0,0 +1,86 @@
+#include <rnd/stonesngems.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace stonesngems;
+
+struct Case {
+    std::string name;
+    std::string board_str;
+    bool unsolvable;
+};
+
+auto test_unsolvable_cases() -> bool {
+    const std::vector<Case> cases{
+        {"small board", SMALL_BOARD_STR, false},
+        // Three gems required with one diamond on the board
+        {"too few diamonds",
+         "5|6|-1|3|19|19|19|19|19|19|19|00|02|05|01|19|19|02|02|02|01|19|19|01|01|01|07|19|19|19|19|19|19|19", true},
+        // Two nuts make up the missing gems
+        {"nuts",
+         "5|6|-1|3|19|19|19|19|19|19|19|00|02|05|39|19|19|02|02|39|01|19|19|01|01|01|07|19|19|19|19|19|19|19", false},
+        // A butterfly can explode into the missing gems
+        {"butterfly",
+         "5|6|-1|3|19|19|19|19|19|19|19|00|02|05|01|19|19|02|02|14|01|19|19|01|01|01|07|19|19|19|19|19|19|19", false},
+        // Growing blobs can turn into any number of diamonds
+        {"blob",
+         "5|6|-1|3|19|19|19|19|19|19|19|00|02|05|01|19|19|02|02|23|01|19|19|01|01|01|07|19|19|19|19|19|19|19", false},
+        // Steel walls seal the exit off
+        {"sealed exit",
+         "5|6|-1|1|19|19|19|19|19|19|19|00|02|05|01|19|19|02|02|02|19|19|19|01|01|19|07|19|19|19|19|19|19|19", true},
+        // Brick walls can be blown up, so the exit is not sealed
+        {"brick wall",
+         "5|6|-1|1|19|19|19|19|19|19|19|00|02|05|01|19|19|02|02|02|18|19|19|01|01|18|07|19|19|19|19|19|19|19", false},
+        // The exit is five steps away, which needs six steps remaining
+        {"enough steps",
+         "5|6|6|0|19|19|19|19|19|19|19|00|02|02|01|19|19|02|02|02|01|19|19|01|01|01|08|19|19|19|19|19|19|19", false},
+        {"too few steps",
+         "5|6|5|0|19|19|19|19|19|19|19|00|02|02|01|19|19|02|02|02|01|19|19|01|01|01|08|19|19|19|19|19|19|19", true},
+    };
+    for (const auto &c : cases) {
+        if (make_state(c.board_str).is_provably_unsolvable() != c.unsolvable) {
+            std::cout << "Unsolvable check wrong for " << c.name << "." << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Unsolvable checks correct." << std::endl;
+    return true;
+}
+
+// Soundness: the check must never fire on a state which bfs can still solve
+auto test_unsolvable_sound() -> bool {
+    const std::vector<std::string> boards{
+        SMALL_BOARD_STR,
+        "5|6|12|1|19|19|19|19|19|19|19|00|02|05|01|19|19|02|03|02|01|19|19|01|01|01|07|19|19|19|19|19|19|19",
+    };
+    uint64_t rng = 1;
+    int num_checked = 0;
+    for (const auto &board_str : boards) {
+        for (int walk = 0; walk < 20; ++walk) {
+            RNDGameState state = make_state(board_str);
+            for (int step = 0; step < 8 && !state.is_terminal() && !state.is_solution(); ++step) {
+                rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+                state.apply_action(RNDGameState::ALL_ACTIONS[(rng >> 33) % RNDGameState::ALL_ACTIONS.size()]);
+                if (state.is_provably_unsolvable() && bfs_solve(state).solved) {
+                    std::cout << "Unsolvable check fired on a solvable state." << std::endl;
+                    return false;
+                }
+                ++num_checked;
+            }
+        }
+    }
+    std::cout << "Unsolvable check sound on " << num_checked << " states." << std::endl;
+    return true;
+}
+
+int main() {
+    const bool passed = test_unsolvable_cases() && test_unsolvable_sound();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
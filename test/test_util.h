@@ -0,0 +1,90 @@
+#ifndef STONESNGEMS_TEST_UTIL_H_
+#define STONESNGEMS_TEST_UTIL_H_
+
+// Fixtures shared by the test executables
+
+#include <rnd/stonesngems.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+// Collect the diamond two steps right, then walk to the exit two rows down
+inline const std::string SMALL_BOARD_STR =
+    "5|6|-1|1|"
+    "19|19|19|19|19|19|"
+    "19|00|02|05|01|19|"
+    "19|02|02|02|01|19|"
+    "19|01|01|01|07|19|"
+    "19|19|19|19|19|19";
+constexpr std::size_t SMALL_BOARD_SOLUTION_LENGTH = 5;
+
+// Diamond sealed off behind steel walls
+inline const std::string UNSOLVABLE_BOARD_STR =
+    "5|6|-1|1|"
+    "19|19|19|19|19|19|"
+    "19|00|02|19|05|19|"
+    "19|02|02|19|19|19|"
+    "19|01|01|01|07|19|"
+    "19|19|19|19|19|19";
+
+inline auto make_state(const std::string &board_str) -> stonesngems::RNDGameState {
+    stonesngems::GameParameters params = stonesngems::kDefaultGameParams;
+    params["game_board_str"] = stonesngems::GameParameter(board_str);
+    return stonesngems::RNDGameState(params);
+}
+
+/**
+ * Check a search result by replaying its solution from the root.
+ * @param state The root state searched from
+ * @param result The search result
+ * @param name Solver and setup, used in the printed message
+ * @param expected_length Length the solution must have, 0 to accept any length
+ * @return True if the result is solved and its solution reaches the exit
+ */
+inline auto check_solution(const stonesngems::RNDGameState &state, const stonesngems::SearchResult &result,
+                           const std::string &name, std::size_t expected_length) -> bool {
+    if (!result.solved || (expected_length > 0 && result.solution.size() != expected_length)) {
+        std::cout << name << " did not find the expected solution." << std::endl;
+        return false;
+    }
+    stonesngems::RNDGameState replay = state;
+    for (const auto action : result.solution) {
+        replay.apply_action(action);
+    }
+    if (!replay.is_solution()) {
+        std::cout << name << " returned an invalid solution." << std::endl;
+        return false;
+    }
+    std::cout << name << " solved in " << result.solution.size() << " steps." << std::endl;
+    return true;
+}
+
+// Define SNG_TEST_COUNT_ALLOCATIONS before including to count heap allocations in num_allocations. The replacement
+// operators are not inline, so only one translation unit of a test executable may define it.
+#ifdef SNG_TEST_COUNT_ALLOCATIONS
+inline std::atomic<std::size_t> num_allocations{0};
+
+// NOLINTBEGIN
+void *operator new(std::size_t size) {
+    ++num_allocations;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+// NOLINTEND
+#endif
+
+#endif    // STONESNGEMS_TEST_UTIL_H_
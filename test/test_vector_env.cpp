@@ -0,0 +1,93 @@
+#include <rnd/stonesngems.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace stonesngems;
+
+constexpr std::size_t NUM_ENVS = 13;
+constexpr std::size_t NUM_STEPS = 300;
+
+const std::string BOARD_STR =
+    "14|14|-1|1|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18|07|01|01|18|01|01|01|01|18|02|02|05|18|18|02|01|01|18|"
+    "02|02|02|02|18|02|32|01|18|18|01|01|02|36|02|02|02|01|18|01|01|02|18|18|18|18|18|18|01|01|01|01|18|34|18|18|"
+    "18|18|01|02|02|01|01|02|02|02|01|02|02|02|18|18|02|02|02|35|02|01|02|02|02|02|01|01|18|18|01|01|02|02|01|02|"
+    "02|01|02|02|01|01|18|18|02|02|02|01|02|01|01|02|01|01|02|02|18|18|18|18|18|18|00|02|01|01|18|18|18|18|18|18|"
+    "01|01|29|18|02|01|02|02|18|02|01|02|18|18|02|01|02|18|02|01|02|02|18|02|02|01|18|18|01|01|01|31|01|01|02|01|"
+    "28|01|38|02|18|18|18|18|18|18|18|18|18|18|18|18|18|18|18";
+
+// Step a VectorEnv and the same environments one at a time, checking the batched buffers match
+auto test_vector_env(std::size_t num_threads) -> bool {
+    std::vector<GameParameters> params;
+    for (std::size_t i = 0; i < NUM_ENVS; ++i) {
+        GameParameters p = kDefaultGameParams;
+        p["rng_seed"] = GameParameter(static_cast<int>(i));
+        params.push_back(p);
+    }
+    VectorEnv env(params, num_threads);
+    std::vector<RNDGameState> states;
+    for (const auto &p : params) {
+        states.emplace_back(p);
+    }
+    const std::size_t obs_size = states.front().get_observation().size();
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> dist(0, RNDGameState::action_space_size() - 1);
+    std::vector<Action> actions(NUM_ENVS);
+    std::size_t num_terminals = 0;
+    for (std::size_t step = 0; step < NUM_STEPS; ++step) {
+        for (auto &action : actions) {
+            action = ALL_ACTIONS[dist(gen)];    // NOLINT(*-bounds-constant-array-index)
+        }
+        env.step(actions);
+        for (std::size_t i = 0; i < NUM_ENVS; ++i) {
+            states[i].apply_action(actions[i]);
+            const bool terminal = states[i].is_terminal();
+            if (env.rewards()[i] != states[i].get_current_reward() ||
+                env.reward_signals()[i] != states[i].get_reward_signal() ||
+                (env.terminals()[i] != 0) != terminal) {
+                std::cout << "VectorEnv step result error at step " << step << "." << std::endl;
+                return false;
+            }
+            if (terminal) {
+                states[i].reset();
+                ++num_terminals;
+            }
+            const std::vector<float> obs = states[i].get_observation();
+            const auto env_obs = env.observations().begin() + static_cast<std::ptrdiff_t>(i * obs_size);
+            if (!std::equal(obs.begin(), obs.end(), env_obs)) {
+                std::cout << "VectorEnv observation error at step " << step << "." << std::endl;
+                return false;
+            }
+        }
+    }
+    if (num_terminals == 0) {
+        std::cout << "VectorEnv never reset an environment." << std::endl;
+        return false;
+    }
+    std::cout << "VectorEnv with " << num_threads << " threads matches individual states." << std::endl;
+    return true;
+}
+
+auto test_vector_env_shape_mismatch() -> bool {
+    GameParameters other = kDefaultGameParams;
+    other["game_board_str"] = GameParameter(BOARD_STR);
+    try {
+        VectorEnv env({kDefaultGameParams, other});
+    } catch (const std::invalid_argument &) {
+        std::cout << "VectorEnv rejects mismatched observation shapes." << std::endl;
+        return true;
+    }
+    std::cout << "VectorEnv accepted mismatched observation shapes." << std::endl;
+    return false;
+}
+
+int main() {
+    const bool passed = test_vector_env(1) && test_vector_env(3) && test_vector_env_shape_mismatch();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}